@@ -0,0 +1,31 @@
+#ifndef BENCH_BOARD_H
+#define BENCH_BOARD_H
+
+#include "../game.h"
+
+// Shared by the benchmarks that need a long snake that never dies: a
+// path that covers the whole board, and a way to grow the snake along it.
+
+// Boustrophedon over every row; with an even row count it is a cycle
+inline Direction serpentine(const GameState& state) {
+    const SnakeSegment& head = state.snake.head();
+    if (state.direction == DOWN) {
+        return head.x == 0 ? RIGHT : LEFT;
+    }
+    if ((state.direction == RIGHT && head.x == state.config.cols - 1) || (state.direction == LEFT && head.x == 0)) {
+        return DOWN;
+    }
+    return state.direction;
+}
+
+// Grows the snake by putting food in front of its head until fits says stop
+template <typename Fits>
+void growSnake(GameState& state, Fits fits) {
+    while (!fits(state) && state.result == RUNNING) {
+        Direction next = serpentine(state);
+        state.food = nextCell(state, state.snake.head(), next);
+        step(state, next);
+    }
+}
+
+#endif
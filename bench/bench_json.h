@@ -0,0 +1,56 @@
+#ifndef BENCH_JSON_H
+#define BENCH_JSON_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Shared by the benchmarks that report JSON (make bench-json): a timing
+// loop that sizes its own batch, and a printer that puts one result per
+// line so two runs can be compared with diff or a script.
+
+struct BenchResult {
+    std::string name;
+    std::string param;      // What value varies, e.g. "length"
+    double value;
+    double nsPerOp;
+    long long iterations;
+    long long bytes = -1;   // Memory the measured structure holds, when it reports one
+};
+
+// Runs op in batches, doubling the batch until one takes minSeconds, and
+// returns the nanoseconds per call of that last batch. op should do a
+// fixed amount of work per call and keep its result observable.
+template <typename Op>
+double timeOp(Op op, long long& iterations, double minSeconds = 0.2) {
+    long long batch = 1;
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < batch; ++i) {
+            op();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= minSeconds || batch >= (1LL << 40)) {
+            iterations = batch;
+            return elapsed * 1e9 / batch;
+        }
+        batch *= 2;
+    }
+}
+
+inline void printBenchJson(const char* suite, const std::vector<BenchResult>& results) {
+    std::printf("{\"suite\": \"%s\", \"results\": [\n", suite);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        std::printf("  {\"name\": \"%s\", \"%s\": %g, \"ns_per_op\": %.2f, \"iterations\": %lld",
+                    result.name.c_str(), result.param.c_str(), result.value, result.nsPerOp, result.iterations);
+        if (result.bytes >= 0) {
+            std::printf(", \"bytes\": %lld", result.bytes);
+        }
+        std::printf("}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::printf("]}\n");
+}
+
+#endif
@@ -0,0 +1,109 @@
+// The three ways the tree can store a snake's body, reported as JSON like
+// core_bench: SnakeBody's std::vector<SnakeSegment> ring, 8 bytes a
+// segment; RunBody's straight runs; and DirectionBody's 2-bit moves.
+// For several lengths each gets
+//
+//   tick   dropping the tail and pushing a head, as step() does
+//   walk   rebuilding every cell head first, per cell, as a snapshot or
+//          render pass over the body would
+//
+// with the bytes its storage holds at that length. The snake wanders the
+// plane turning every 8 moves on average, which is about how often the
+// bots turn, so RunBody has a run per 8 cells or so.
+//
+//   body_bench [min seconds per result]
+#include "bench_json.h"
+#include "../direction_body.h"
+#include "../run_body.h"
+#include "../snake_body.h"
+
+#include <cstdlib>
+
+static long long sink = 0;
+
+const int MOVE_X[4] = {0, 0, -1, 1};
+const int MOVE_Y[4] = {-1, 1, 0, 0};
+const int WALK_MOVES = 1 << 16;
+
+// A fixed random sequence of moves with no reversals, repeated as needed,
+// so every body sees the same ones
+static std::vector<int> makeWalk() {
+    std::vector<int> walk;
+    uint64_t state = 1;
+    int direction = 3;
+    for (int i = 0; i < WALK_MOVES; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        if ((state >> 61) == 0) {
+            direction = (direction < 2 ? 2 : 0) + static_cast<int>((state >> 33) & 1);
+        }
+        walk.push_back(direction);
+    }
+    return walk;
+}
+
+static long long storageBytes(const SnakeBody& body) {
+    return static_cast<long long>(body.capacity()) * sizeof(SnakeSegment);
+}
+
+static long long storageBytes(const RunBody& body) {
+    return static_cast<long long>(body.capacity()) * sizeof(SnakeRun);
+}
+
+static long long storageBytes(const DirectionBody& body) {
+    return body.capacity() / 4;
+}
+
+template <typename Body>
+static void pushMove(Body& body, int move) {
+    const SnakeSegment& head = body.head();
+    body.pushHead({head.x + MOVE_X[move], head.y + MOVE_Y[move]});
+}
+
+template <typename Body>
+static void benchBody(const char* name, Body& body, int length, const std::vector<int>& walk, double minSeconds,
+                      std::vector<BenchResult>& results) {
+    int next = 0;
+    body.clear();
+    body.pushHead({0, 0});
+    while (body.size() < length) {
+        pushMove(body, walk[next]);
+        next = (next + 1) & (WALK_MOVES - 1);
+    }
+
+    long long iterations = 0;
+    double ns = timeOp([&]() {
+        sink += body.tail().x;
+        body.popTail();
+        pushMove(body, walk[next]);
+        next = (next + 1) & (WALK_MOVES - 1);
+    }, iterations, minSeconds);
+    std::string prefix = name;
+    results.push_back({prefix + "_tick", "length", static_cast<double>(length), ns, iterations, storageBytes(body)});
+
+    iterations = 0;
+    ns = timeOp([&]() {
+        body.forEach([](const SnakeSegment& cell) { sink += cell.x; });
+    }, iterations, minSeconds);
+    results.push_back({prefix + "_walk", "length", static_cast<double>(length), ns / length, iterations * length});
+}
+
+int main(int argc, char* args[]) {
+    double minSeconds = argc > 1 ? std::atof(args[1]) : 0.2;
+
+    std::vector<int> walk = makeWalk();
+
+    std::vector<BenchResult> results;
+    const int lengths[] = {100, 10000, 1000000};
+    for (int length : lengths) {
+        SnakeBody segments(length);
+        RunBody runs;
+        DirectionBody packed;
+        benchBody("segments", segments, length, walk, minSeconds, results);
+        benchBody("runs", runs, length, walk, minSeconds, results);
+        benchBody("packed", packed, length, walk, minSeconds, results);
+    }
+
+    printBenchJson("body", results);
+    std::fprintf(stderr, "(checksum %lld)\n", sink);
+    return 0;
+}
@@ -0,0 +1,148 @@
+// The game's per-step hot paths, reported as JSON for comparing runs:
+// step() at several snake lengths, spawnFood() and spawnBonusFood() at
+// several board fill ratios, and the wall test behind every move. Also
+// initGame() and resetGame() on the game's board and on the largest one,
+// where setting up a board can cost more than playing on it.
+//
+//   core_bench [min seconds per result]
+#include "bench_board.h"
+#include "bench_json.h"
+#include "../game.h"
+
+#include <chrono>
+#include <cstdlib>
+
+static long long sink = 0;
+
+static BenchResult benchStep(int length, double minSeconds) {
+    GameConfig config;
+    config.cols = 128;
+    config.rows = 96;
+    GameState state;
+    initGame(state, config, 1);
+    growSnake(state, [length](const GameState& s) { return s.snake.size() >= length; });
+
+    // The food always sits in the cell the tail just left, which the head
+    // reaches again only a full lap later, so the length stays fixed
+    long long iterations = 0;
+    double ns = timeOp([&state]() {
+        SnakeSegment tail = state.snake.tail();
+        step(state, serpentine(state));
+        state.food = tail;
+    }, iterations, minSeconds);
+    sink += state.snake.size();
+    return {"step", "length", static_cast<double>(length), ns, iterations};
+}
+
+// Fill is the share of food-eligible cells under the snake
+static GameState filledBoard(double fill) {
+    GameConfig config;
+    GameState state;
+    initGame(state, config, 1);
+    int eligible = state.freeCells.size() + 1;      // Plus the cell under the starting head
+    int wantedFree = static_cast<int>(eligible * (1 - fill));
+    growSnake(state, [wantedFree](const GameState& s) { return s.freeCells.size() <= wantedFree; });
+    return state;
+}
+
+static BenchResult benchSpawnFood(double fill, double minSeconds) {
+    GameState state = filledBoard(fill);
+    long long iterations = 0;
+    double ns = timeOp([&state]() {
+        spawnFood(state);
+        sink += state.food.x;
+    }, iterations, minSeconds);
+    return {"spawn_food", "fill", fill, ns, iterations};
+}
+
+static BenchResult benchSpawnBonusFood(double fill, double minSeconds) {
+    GameState state = filledBoard(fill);
+    long long iterations = 0;
+    double ns = timeOp([&state]() {
+        spawnBonusFood(state);
+        sink += state.bonusFood.x;
+    }, iterations, minSeconds);
+    return {"spawn_bonus_food", "fill", fill, ns, iterations};
+}
+
+// The game's own level, from level.h
+static BenchResult benchWallTest(double minSeconds) {
+    GameConfig config;
+    config.cols = GRID_COLS;
+    config.rows = GRID_ROWS;
+    config.tileSize = TILE_SIZE;
+    config.walls = levelWalls;
+    GameState state;
+    initGame(state, config, 1);
+
+    const int CELLS = 4096;
+    std::vector<SnakeSegment> cells(CELLS);
+    for (SnakeSegment& cell : cells) {
+        cell = {state.rng.below(config.cols), state.rng.below(config.rows)};
+    }
+
+    int next = 0;
+    long long iterations = 0;
+    double ns = timeOp([&]() {
+        const SnakeSegment& cell = cells[next];
+        next = (next + 1) & (CELLS - 1);
+        sink += isWallAt(state, cell.x, cell.y);
+    }, iterations, minSeconds);
+    return {"wall_test", "walls", static_cast<double>(config.walls.size()), ns, iterations};
+}
+
+// initGame() once, then resetGame() after each of a run of short games.
+// Only the resets are timed; the games between them are what they undo.
+static void benchBoardSetup(int cols, int rows, double minSeconds, std::vector<BenchResult>& results) {
+    const int GAME_TICKS = 1000;
+    GameConfig config;
+    config.cols = cols;
+    config.rows = rows;
+    GameState state;
+    double cells = static_cast<double>(cols) * rows;
+
+    auto start = std::chrono::steady_clock::now();
+    initGame(state, config, 1);
+    std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+    results.push_back({"init_game", "cells", cells, spent.count() * 1e9, 1});
+
+    long long resets = 0;
+    spent = spent.zero();
+    while (spent.count() < minSeconds) {
+        for (int i = 0; i < GAME_TICKS && state.result == RUNNING; ++i) {
+            step(state, serpentine(state));
+        }
+        start = std::chrono::steady_clock::now();
+        resetGame(state, ++resets);
+        spent += std::chrono::steady_clock::now() - start;
+    }
+    sink += state.food.x;
+    results.push_back({"reset_game", "cells", cells, spent.count() * 1e9 / resets, resets});
+}
+
+int main(int argc, char* args[]) {
+    double minSeconds = argc > 1 ? std::atof(args[1]) : 0.2;
+
+    std::vector<BenchResult> results;
+    const int lengths[] = {1, 100, 1000, 10000};
+    for (int length : lengths) {
+        results.push_back(benchStep(length, minSeconds));
+    }
+
+    const double fills[] = {0.0, 0.5, 0.9, 0.99};
+    for (double fill : fills) {
+        results.push_back(benchSpawnFood(fill, minSeconds));
+    }
+    for (double fill : fills) {
+        results.push_back(benchSpawnBonusFood(fill, minSeconds));
+    }
+
+    results.push_back(benchWallTest(minSeconds));
+
+    benchBoardSetup(GRID_COLS, GRID_ROWS, minSeconds, results);
+    benchBoardSetup(MAX_BOARD_SIDE, MAX_BOARD_SIDE, minSeconds, results);
+
+    printBenchJson("core", results);
+    std::fprintf(stderr, "(checksum %lld)\n", sink);
+    return 0;
+}
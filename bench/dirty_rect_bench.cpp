@@ -0,0 +1,129 @@
+// Frame time of the game's own renderFrame() drawing the full redraw it
+// does by default against the incremental SceneCache path (--incremental
+// in main), with the snake stepping once per frame. The board is 320x240
+// cells of 2 pixels, so the frame is the game's 640x480, and the snake
+// runs a serpentine path that never dies. It is grown to each length first
+// by putting food in front of its head. Only renderFrame() is timed; the
+// snapshot it draws is taken outside, as the simulation thread takes it in
+// the game.
+//
+//   dirty_rect_bench [frames] [renderer] [font]
+//
+// Uses the software renderer on an offscreen surface unless "window" is
+// passed, in which case the default renderer of a real window is used.
+// Needs SDL_ttf for the score text; the font defaults to the game's
+// Moonlight.otf, so run it from the repository root.
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "bench_board.h"
+#include "../frame_renderer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#undef main
+
+const int COLS = 320;
+const int ROWS = 240;
+const int TILE = 2;
+
+// Mean milliseconds per renderFrame() over frames steps, drawn the way
+// frame.incremental says
+static double benchFrames(FrameRenderer& frame, GameState& state, int frames) {
+    GameSnapshot view;
+    takeSnapshot(view, state, frame.incremental);
+    // The first frame builds the background and, when incremental, repaints the whole scene
+    renderFrame(frame, state, view, 1.0f);
+
+    std::chrono::steady_clock::duration spent{};
+    for (int i = 0; i < frames; ++i) {
+        step(state, serpentine(state));
+        takeSnapshot(view, state, frame.incremental);
+
+        auto start = std::chrono::steady_clock::now();
+        renderFrame(frame, state, view, 1.0f);
+        spent += std::chrono::steady_clock::now() - start;
+    }
+    return std::chrono::duration<double, std::milli>(spent).count() / frames;
+}
+
+int main(int argc, char* args[]) {
+    int frames = argc > 1 ? std::atoi(args[1]) : 200;
+    bool useWindow = argc > 2 && std::string(args[2]) == "window";
+    const char* fontPath = argc > 3 ? args[3] : "Moonlight.otf";
+
+    if (SDL_Init(useWindow ? SDL_INIT_VIDEO : 0) < 0 || TTF_Init() < 0) {
+        std::fprintf(stderr, "SDL initialization failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Window* window = nullptr;
+    SDL_Surface* surface = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (useWindow) {
+        window = SDL_CreateWindow("dirty_rect_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                  COLS * TILE, ROWS * TILE, SDL_WINDOW_SHOWN);
+        renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    } else {
+        surface = SDL_CreateRGBSurfaceWithFormat(0, COLS * TILE, ROWS * TILE, 32, SDL_PIXELFORMAT_RGBA32);
+        renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    }
+    TTF_Font* font = TTF_OpenFont(fontPath, 40);
+    GlyphAtlas atlas;
+    if (!renderer || !font || !createGlyphAtlas(renderer, font, atlas)) {
+        std::fprintf(stderr, "Failed to set up rendering: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    FrameRenderer frame;
+    initFrameRenderer(frame, renderer, COLS * TILE, ROWS * TILE, TILE, &atlas);
+    if (!createScene(frame)) {
+        std::fprintf(stderr, "Renderer cannot draw into textures: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_RendererInfo info;
+    SDL_GetRendererInfo(renderer, &info);
+    std::printf("renderer: %s, %d frames per length\n", info.name, frames);
+    std::printf("%10s %14s %14s %10s\n", "length", "full ms", "dirty ms", "speedup");
+
+    GameConfig config;
+    config.cols = COLS;
+    config.rows = ROWS;
+    config.tileSize = TILE;
+
+    const int lengths[] = {100, 10000, 50000};
+    for (int length : lengths) {
+        GameState state;
+        initGame(state, config, 1);
+        growSnake(state, [length](const GameState& s) { return s.snake.size() >= length; });
+
+        // Same starting position for both modes
+        GameState copy = state;
+        frame.incremental = false;
+        double full = benchFrames(frame, copy, frames);
+        frame.incremental = true;
+        invalidateSceneCache(frame.scene);
+        double dirty = benchFrames(frame, state, frames);
+        std::printf("%10d %14.3f %14.3f %9.1fx\n", length, full, dirty, full / dirty);
+    }
+
+    destroyFrameRenderer(frame);
+    destroyGlyphAtlas(atlas);
+    TTF_CloseFont(font);
+    SDL_DestroyRenderer(renderer);
+    if (surface) {
+        SDL_FreeSurface(surface);
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,107 @@
+// One full game frame drawn by the game's own renderFrame(), offscreen
+// with the software renderer, reported as JSON like core_bench. The snake
+// is laid out in rows at several lengths:
+//
+//   frame          the game's 64x48 board: the cached background, the body
+//                  (one rect per straight run) and food in one batch per
+//                  color, the head, the score and level text from the
+//                  glyph atlas, and the present
+//   frame_camera   a 1024x1024 board drawn through the camera following
+//                  the head, culled to the cells in view
+//
+//   frame_bench [min seconds per result] [font]
+//
+// Needs SDL and SDL_ttf; the font defaults to the game's Moonlight.otf,
+// so run it from the repository root.
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "bench_json.h"
+#include "../frame_renderer.h"
+#include "../run_body.h"
+
+#include <cstdlib>
+#include <string>
+
+#undef main
+
+const int COLS = 64;
+const int ROWS = 48;
+const int TILE = 10;
+const int WIDTH = COLS * TILE;
+const int HEIGHT = ROWS * TILE;
+const int CAMERA_SIDE = 1024;
+
+static GameSnapshot layOutSnake(int cols, int rows, int length) {
+    GameSnapshot view;
+    RunBody snake;
+    for (int i = length - 1; i >= 0; --i) {
+        int row = i / cols;
+        int col = i % cols;
+        SnakeSegment segment = {row % 2 == 0 ? col : cols - 1 - col, row};
+        snake.pushHead(segment);
+    }
+    snake.forEachRun([&view](const SnakeRun& run) { view.runs.push_back(run); });
+    view.length = snake.size();
+    view.previousHead = snake.head();
+    view.food = {cols - 2, rows - 2};
+    view.score = length * 10;
+    return view;
+}
+
+static void benchFrames(const char* name, FrameRenderer& frame, int cols, int rows, const int* lengths, int count,
+                        double minSeconds, std::vector<BenchResult>& results) {
+    GameConfig config;
+    config.cols = cols;
+    config.rows = rows;
+    config.tileSize = TILE;
+    GameState game;
+    initGame(game, config, 1);
+    frame.followCamera = cols != COLS || rows != ROWS;
+    invalidateBackground(frame);
+
+    for (int i = 0; i < count; ++i) {
+        GameSnapshot view = layOutSnake(cols, rows, lengths[i]);
+        long long iterations = 0;
+        double ns = timeOp([&]() { renderFrame(frame, game, view, 1.0f); }, iterations, minSeconds);
+        results.push_back({name, "length", static_cast<double>(lengths[i]), ns, iterations});
+    }
+}
+
+int main(int argc, char* args[]) {
+    double minSeconds = argc > 1 ? std::atof(args[1]) : 0.2;
+    const char* fontPath = argc > 2 ? args[2] : "Moonlight.otf";
+
+    if (SDL_Init(0) < 0 || TTF_Init() < 0) {
+        std::fprintf(stderr, "SDL initialization failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    TTF_Font* font = TTF_OpenFont(fontPath, 40);
+    GlyphAtlas atlas;
+    if (!renderer || !font || !createGlyphAtlas(renderer, font, atlas)) {
+        std::fprintf(stderr, "Failed to set up rendering: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    FrameRenderer frame;
+    initFrameRenderer(frame, renderer, WIDTH, HEIGHT, TILE, &atlas);
+
+    std::vector<BenchResult> results;
+    const int lengths[] = {10, 1000, 3000};
+    benchFrames("frame", frame, COLS, ROWS, lengths, 3, minSeconds, results);
+    const int cameraLengths[] = {1000, 100000, 1000000};
+    benchFrames("frame_camera", frame, CAMERA_SIDE, CAMERA_SIDE, cameraLengths, 3, minSeconds, results);
+
+    printBenchJson("frame", results);
+
+    destroyFrameRenderer(frame);
+    destroyGlyphAtlas(atlas);
+    TTF_CloseFont(font);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
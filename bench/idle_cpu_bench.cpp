@@ -0,0 +1,210 @@
+// Measures how much CPU the game's idle screens burn, by running the real
+// game with no input and reading back the CPU time it used:
+//
+//   welcome    main --menu-idle N sits on the welcome screen for N seconds
+//   game over  main --replay plays a one-step replay, then holds the game
+//              over screen for N seconds with --game-over-idle N
+//
+// Each run's fixed cost is subtracted: startup and shutdown (a near-zero
+// --menu-idle) from the welcome screen, and everything up to the game
+// over screen appearing (a near-zero --game-over-idle) from the game over
+// screen. The rest is reported as CPU seconds per idle minute. For comparison it also runs the busy SDL_PollEvent loop the
+// welcome screen used before it was made event driven, in this process.
+//
+// Last, it paces empty 60 fps frames for the same time, as the game does
+// without vsync: once with waitForFrameDeadline() and once with the wait it
+// replaced, which spun out the last 2 ms of every frame. Each reports its
+// CPU time and how late its frames ended on average.
+//
+//   idle_cpu_bench [seconds] [path to main]
+//
+// Works with SDL_VIDEODRIVER=dummy on machines without a display; run it
+// from the repository root so main finds its font.
+#include <SDL2/SDL.h>
+
+#include "../frame_renderer.h"
+#include "../replay.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#undef main
+
+const int TARGET_FRAME_RATE = 60;           // As in main.cpp
+const char* const REPLAY_PATH = "idle_cpu_bench.replay";
+
+static double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exitTime, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user);
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 1e7;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+// Runs the game with these arguments to completion and returns the CPU
+// seconds it used, or -1 if it could not be run
+static double childCpuSeconds(const std::string& program, const std::string& arguments) {
+#ifdef _WIN32
+    std::string commandLine = "\"" + program + "\" " + arguments;
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    PROCESS_INFORMATION process;
+    if (!CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup,
+                        &process)) {
+        return -1;
+    }
+    WaitForSingleObject(process.hProcess, INFINITE);
+    FILETIME creation, exitTime, kernel, user;
+    GetProcessTimes(process.hProcess, &creation, &exitTime, &kernel, &user);
+    CloseHandle(process.hThread);
+    CloseHandle(process.hProcess);
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 1e7;
+#else
+    pid_t pid = fork();
+    if (pid < 0) {
+        return -1;
+    }
+    if (pid == 0) {
+        std::string command = "exec \"" + program + "\" " + arguments;
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status;
+    rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) == 127) {
+        return -1;
+    }
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec +
+           usage.ru_stime.tv_usec / 1e6;
+#endif
+}
+
+// The welcome screen loop before it was made event driven
+static void idleBusyPoll(Uint32 durationMs) {
+    SDL_Event e;
+    Uint32 start = SDL_GetTicks();
+    while (SDL_GetTicks() - start < durationMs) {
+        while (SDL_PollEvent(&e) != 0) {
+        }
+    }
+}
+
+// The frame wait before waitForFrameDeadline() slept the whole way
+static void waitWithSpin(Uint64 deadline) {
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    const Uint64 sleepMargin = counterFrequency / 500; // 2 ms
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (now + sleepMargin < deadline) {
+        SDL_Delay(static_cast<Uint32>((deadline - now - sleepMargin) * 1000 / counterFrequency) + 1);
+        now = SDL_GetPerformanceCounter();
+    }
+    while (now < deadline) {
+        now = SDL_GetPerformanceCounter();
+    }
+}
+
+// Paces empty frames with wait for durationMs, the way the game loop does,
+// and returns how late the frames ended on average, in milliseconds
+static double paceFrames(void (*wait)(Uint64), Uint32 durationMs) {
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    const Uint64 frameTicks = counterFrequency / TARGET_FRAME_RATE;
+    const int frames = static_cast<int>(static_cast<Uint64>(durationMs) * TARGET_FRAME_RATE / 1000);
+    Uint64 lateTicks = 0;
+    for (int i = 0; i < frames; ++i) {
+        Uint64 deadline = SDL_GetPerformanceCounter() + frameTicks;
+        wait(deadline);
+        lateTicks += SDL_GetPerformanceCounter() - deadline;
+    }
+    return frames > 0 ? lateTicks * 1000.0 / counterFrequency / frames : 0.0;
+}
+
+static void report(const char* name, double idleSeconds, double cpu) {
+    std::printf("%-22s %8.2f s idle %8.3f s cpu %10.3f cpu-s per idle minute\n", name, idleSeconds, cpu,
+                cpu / idleSeconds * 60.0);
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 10;
+    if (seconds <= 0) {
+        seconds = 10;
+    }
+#ifdef _WIN32
+    std::string program = argc > 2 ? argv[2] : "main.exe";
+#else
+    std::string program = argc > 2 ? argv[2] : "./main";
+#endif
+
+    // A game that ends after one step, so playing it goes straight to the game over screen
+    Replay replay;
+    GameConfig config;
+    beginReplay(replay, config, 1);
+    recordInput(replay, RIGHT);
+    if (!saveReplay(replay, REPLAY_PATH)) {
+        std::fprintf(stderr, "Failed to write %s\n", REPLAY_PATH);
+        return 1;
+    }
+
+    double startup = childCpuSeconds(program, "--menu-idle 0.001");
+    double welcome = childCpuSeconds(program, "--menu-idle " + std::to_string(seconds));
+    std::string replayArguments = std::string("--replay ") + REPLAY_PATH;
+    double gameOverStart = childCpuSeconds(program, replayArguments + " --game-over-idle 0.001");
+    double gameOver = childCpuSeconds(program, replayArguments + " --game-over-idle " + std::to_string(seconds));
+    std::remove(REPLAY_PATH);
+    if (startup < 0 || welcome < 0 || gameOverStart < 0 || gameOver < 0) {
+        std::fprintf(stderr, "Failed to run %s\n", program.c_str());
+        return 1;
+    }
+    std::printf("%-22s %8.3f s cpu\n", "startup and shutdown", startup);
+    report("welcome screen", seconds, std::max(welcome - startup, 0.0));
+    report("game over screen", seconds, std::max(gameOver - gameOverStart, 0.0));
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        std::fprintf(stderr, "SDL initialization failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    // A window makes the event pump behave like it does in the game
+    SDL_Window* window = SDL_CreateWindow("idle_cpu_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          320, 240, SDL_WINDOW_HIDDEN);
+    double cpuStart = processCpuSeconds();
+    idleBusyPoll(seconds * 1000);
+    report("old busy poll loop", seconds, processCpuSeconds() - cpuStart);
+
+    cpuStart = processCpuSeconds();
+    double late = paceFrames(waitForFrameDeadline, seconds * 1000);
+    report("frame wait, sleep", seconds, processCpuSeconds() - cpuStart);
+    std::printf("%-22s %8.3f ms late per frame\n", "", late);
+    cpuStart = processCpuSeconds();
+    late = paceFrames(waitWithSpin, seconds * 1000);
+    report("old frame wait, spin", seconds, processCpuSeconds() - cpuStart);
+    std::printf("%-22s %8.3f ms late per frame\n", "", late);
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
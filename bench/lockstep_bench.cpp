@@ -0,0 +1,96 @@
+// Compares a scalar loop over individual games (GameState + step() driven
+// by chaseMove) with LockstepGames stepping every lane together. Both play
+// under the same policy with no bonus food, as lockstep has none, and
+// restart a game when it ends. The rules still differ in where food lands
+// (see lockstep.h), so the two engines' games are alike, not identical.
+//
+// The board is the game's 64x48 with no walls. The chase policy runs into
+// the main layout's walls after a few dozen ticks, which would leave both
+// loops timing restarts; in the open it lives for well over a thousand.
+// Each scalar restart is still timed and taken out of the scalar rate,
+// while the lockstep rate includes its own cheaper restarts.
+//
+//   lockstep_bench [lanes] [ticks]
+#include "../game.h"
+#include "../bot.h"
+#include "../lockstep.h"
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+
+static GameConfig benchConfig() {
+    GameConfig config;
+    config.cols = GRID_COLS;
+    config.rows = GRID_ROWS;
+    config.walls.clear();               // Open board, see above
+    config.foodPerBonus = INT_MAX;      // Never reached, so no bonus food
+    return config;
+}
+
+static const char* kernelName() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+int main(int argc, char* args[]) {
+    int lanes = argc > 1 ? std::atoi(args[1]) : 4096;
+    int ticks = argc > 2 ? std::atoi(args[2]) : 2000;
+    GameConfig config = benchConfig();
+
+    // Scalar: one game at a time, each for the same number of ticks as a lane
+    long long scalarTicks = 0;
+    long long scalarGames = 0;
+    long long scoreSum = 0;
+    double resetSeconds = 0;
+    GameState game;
+    initGame(game, config, 1);
+    auto start = std::chrono::steady_clock::now();
+    for (int lane = 0; lane < lanes; ++lane) {
+        auto resetStart = std::chrono::steady_clock::now();
+        resetGame(game, lane);
+        resetSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - resetStart).count();
+        for (int t = 0; t < ticks; ++t) {
+            if (step(game, chaseMove(game)) != RUNNING) {
+                ++scalarGames;
+                scoreSum += game.score;
+                resetStart = std::chrono::steady_clock::now();
+                resetGame(game, game.rng.next());
+                resetSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - resetStart).count();
+            }
+        }
+        scalarTicks += ticks;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double scalarSeconds = std::chrono::duration<double>(end - start).count();
+
+    double stepSeconds = scalarSeconds - resetSeconds;
+
+    LockstepGames batch(config, lanes, 1);
+    start = std::chrono::steady_clock::now();
+    batch.run(ticks);
+    end = std::chrono::steady_clock::now();
+    double lockstepSeconds = std::chrono::duration<double>(end - start).count();
+
+    double scalarRate = scalarTicks / stepSeconds;
+    double lockstepRate = batch.ticksSimulated() / lockstepSeconds;
+
+    std::printf("lanes %d, %d ticks each, %s kernel\n", batch.lanes(), ticks, kernelName());
+    std::printf("scalar restarts %.0f ns each, %.0f%% of the scalar loop, not counted below\n",
+                resetSeconds / (lanes + scalarGames) * 1e9, 100.0 * resetSeconds / scalarSeconds);
+    std::printf("%-10s %14s %10s %14s\n", "engine", "ticks/sec", "games", "mean score");
+    std::printf("%-10s %14.0f %10lld %14.1f\n", "scalar", scalarRate, scalarGames,
+                scalarGames ? static_cast<double>(scoreSum) / scalarGames : 0.0);
+    std::printf("%-10s %14.0f %10lld %14.1f\n", "lockstep", lockstepRate, batch.gamesFinished(),
+                batch.gamesFinished() ? static_cast<double>(batch.finishedScore()) / batch.gamesFinished() : 0.0);
+    std::printf("speedup    %.1fx\n", lockstepRate / scalarRate);
+    std::printf("endings    wall %lld, self %lld, full %lld\n", batch.endings(HIT_WALL),
+                batch.endings(HIT_SELF), batch.endings(BOARD_FULL));
+    return 0;
+}
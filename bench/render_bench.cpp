@@ -0,0 +1,120 @@
+// Frame time of drawing the snake with one color change and
+// SDL_RenderFillRect call per segment, as render() used to, against
+// queueing the segments in a RectBatch and drawing them with a single
+// SDL_RenderFillRects. The snake is laid out in rows on a 512x512 board of
+// 2-pixel tiles so even 100k segments fit on screen.
+//
+//   render_bench [frames] [renderer]
+//
+// Draws into an offscreen surface with the software renderer by default,
+// so it needs no display. Pass "window" to use the default accelerated
+// renderer of a real window instead.
+#include <SDL2/SDL.h>
+
+#include "../rect_batch.h"
+#include "../snake_body.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#undef main
+
+const int BOARD_CELLS = 512;
+const int TILE = 2;
+const int SIZE = BOARD_CELLS * TILE;
+
+static void layOutSnake(SnakeBody& snake, int length) {
+    snake.reset(length);
+    for (int i = length - 1; i >= 0; --i) {
+        int row = i / BOARD_CELLS;
+        int col = i % BOARD_CELLS;
+        snake.pushHead({row % 2 == 0 ? col : BOARD_CELLS - 1 - col, row});
+    }
+}
+
+static double benchPerRect(SDL_Renderer* renderer, const SnakeBody& snake, int frames) {
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        snake.forEach([renderer](const SnakeSegment& segment) {
+            SDL_SetRenderDrawColor(renderer, 85, 107, 47, 255);
+            SDL_Rect rect = {segment.x * TILE, segment.y * TILE, TILE, TILE};
+            SDL_RenderFillRect(renderer, &rect);
+        });
+        SDL_RenderPresent(renderer);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+static double benchBatched(SDL_Renderer* renderer, const SnakeBody& snake, int frames) {
+    RectBatch batch;
+    int layer = addRectLayer(batch, {85, 107, 47, 255});
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        snake.forEach([&batch, layer](const SnakeSegment& segment) {
+            queueRect(batch, layer, {segment.x * TILE, segment.y * TILE, TILE, TILE});
+        });
+        flushRects(renderer, batch);
+        SDL_RenderPresent(renderer);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main(int argc, char* args[]) {
+    int frames = argc > 1 ? std::atoi(args[1]) : 50;
+    bool useWindow = argc > 2 && std::string(args[2]) == "window";
+
+    if (SDL_Init(useWindow ? SDL_INIT_VIDEO : 0) < 0) {
+        std::fprintf(stderr, "SDL initialization failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Window* window = nullptr;
+    SDL_Surface* surface = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (useWindow) {
+        window = SDL_CreateWindow("render_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                  SIZE, SIZE, SDL_WINDOW_SHOWN);
+        renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    } else {
+        surface = SDL_CreateRGBSurfaceWithFormat(0, SIZE, SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+        renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    }
+    if (!renderer) {
+        std::fprintf(stderr, "Failed to create renderer: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_RendererInfo info;
+    SDL_GetRendererInfo(renderer, &info);
+    std::printf("renderer: %s, %d frames per size\n", info.name, frames);
+    std::printf("%10s %18s %18s %10s\n", "length", "per-rect ms/frame", "batched ms/frame", "speedup");
+
+    const int lengths[] = {100, 10000, 100000};
+    SnakeBody snake;
+    for (int length : lengths) {
+        layOutSnake(snake, length);
+        double perRect = benchPerRect(renderer, snake, frames);
+        double batched = benchBatched(renderer, snake, frames);
+        std::printf("%10d %18.3f %18.3f %9.1fx\n", length, perRect, batched, perRect / batched);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    if (surface) {
+        SDL_FreeSurface(surface);
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Stress test for SimThread and its triple-buffered snapshots, meant to be
+// built with -fsanitize=thread (make bench/sim_thread_stress). The game
+// steps back to back on a small board while this thread, standing in for
+// the renderer, reads every snapshot it can get and checks it is whole:
+// the body is connected, matches the occupancy bitmap cell for cell, and
+// ticks only go backwards across a restart. It also queues random turns
+// and throws pauses and restarts at the simulation, and when a game ends
+// checks that the replay recorded on the simulation thread plays back to
+// the same result. Exits non-zero on the first torn snapshot or bad replay.
+//
+//   sim_thread_stress [seconds]
+#include "../sim_thread.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+// Short enough to publish far faster than any renderer reads, long enough
+// that the simulation sleeps and sees turns even on a single core
+const std::chrono::microseconds STEP(10);
+
+static int failures = 0;
+
+static void fail(const char* what, long long ticks) {
+    std::fprintf(stderr, "tick %lld: %s\n", ticks, what);
+    ++failures;
+}
+
+static int popcount(const CellBitmap& cells) {
+    int count = 0;
+    for (int w = 0; w < cells.wordCount(); ++w) {
+        count += __builtin_popcountll(cells.word(w));
+    }
+    return count;
+}
+
+static bool adjacent(const GameSnapshot& snapshot, SnakeSegment a, SnakeSegment b) {
+    int dx = std::abs(a.x - b.x);
+    int dy = std::abs(a.y - b.y);
+    // A step across the edge wraps to the other side
+    dx = dx == snapshot.snakeCells.width() - 1 ? 1 : dx;
+    dy = dy == snapshot.snakeCells.height() - 1 ? 1 : dy;
+    return dx + dy == 1;
+}
+
+static void checkSnapshot(const GameSnapshot& snapshot) {
+    // The runs spelled out cell by cell, head first
+    static std::vector<SnakeSegment> body;
+    body.clear();
+    for (const SnakeRun& run : snapshot.runs) {
+        for (int i = 0, length = runLength(run); i < length; ++i) {
+            body.push_back(runCell(run, i));
+        }
+    }
+
+    if (body.empty()) {
+        fail("empty body", snapshot.ticks);
+        return;
+    }
+    if (static_cast<int>(body.size()) != snapshot.length) {
+        fail("runs and length disagree", snapshot.ticks);
+    }
+    if (popcount(snapshot.snakeCells) != static_cast<int>(body.size())) {
+        fail("bitmap and body disagree on length", snapshot.ticks);
+    }
+    for (size_t i = 0; i < body.size(); ++i) {
+        const SnakeSegment& segment = body[i];
+        if (!snapshot.snakeCells.inBounds(segment.x, segment.y) || !snapshot.snakeCells.test(segment.x, segment.y)) {
+            fail("body cell missing from bitmap", snapshot.ticks);
+            return;
+        }
+        if (i > 0 && !adjacent(snapshot, body[i - 1], segment)) {
+            fail("body not connected", snapshot.ticks);
+            return;
+        }
+    }
+}
+
+int main(int argc, char* args[]) {
+    double seconds = argc > 1 ? std::atof(args[1]) : 5.0;
+
+    GameConfig config;
+    config.cols = 16;
+    config.rows = 12;
+
+    GameState game;
+    Replay replay;
+    initGame(game, config, 1);
+
+    Rng rng;
+    rng.seed(42);
+    uint64_t nextSeed = 1;
+    resetGame(game, nextSeed);
+    beginReplay(replay, config, nextSeed);
+
+    SimThread simulation;
+    simulation.start(game, replay, nullptr, STEP, true);
+
+    long long snapshots = 0;
+    long long games = 0;
+    long long restarts = 0;
+    long long lastTicks = 0;
+    bool paused = false;
+    bool restartRequested = false;
+
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < end && failures == 0) {
+        if (simulation.refresh()) {
+            const GameSnapshot& snapshot = simulation.latest();
+            checkSnapshot(snapshot);
+            if (snapshot.ticks < lastTicks) {
+                // Only a restart may take them back, and it is asynchronous
+                if (!restartRequested) {
+                    fail("ticks went backwards", snapshot.ticks);
+                }
+                restartRequested = false;
+            }
+            lastTicks = snapshot.ticks;
+            ++snapshots;
+        }
+
+        if (simulation.finished()) {
+            simulation.stop();
+            finishReplay(replay, game);
+            GameState check;
+            if (!playReplay(check, replay)) {
+                fail("replay did not reproduce the game", game.ticks);
+            }
+            ++games;
+
+            resetGame(game, ++nextSeed);
+            beginReplay(replay, config, nextSeed);
+            paused = false;
+            restartRequested = false;
+            lastTicks = 0;
+            simulation.start(game, replay, nullptr, STEP, true);
+            continue;
+        }
+
+        // Mostly turns, now and then a pause toggle or a restart
+        int action = rng.below(1000000);
+        if (action < 250000) {
+            simulation.queueInput(static_cast<Direction>(rng.below(4)), std::chrono::steady_clock::now());
+        } else if (action < 250002) {
+            paused = !paused;
+            simulation.setPaused(paused);
+        } else if (action < 250003) {
+            simulation.restart(++nextSeed);
+            restartRequested = true;
+            ++restarts;
+        }
+    }
+    simulation.stop();
+
+    std::printf("%lld snapshots checked, %lld games finished, %lld restarts, %d failures\n",
+                snapshots, games, restarts, failures);
+    printLatencySummary(std::cout, "queued turn latency", simulation.inputLatency());
+    return failures > 0 ? 1 : 0;
+}
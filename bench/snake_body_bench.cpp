@@ -0,0 +1,71 @@
+// Compares the old std::vector insert-at-front body with SnakeBody.
+// Each "tick" pushes a new head and drops the tail, like update() does
+// when no food is eaten, so the length stays fixed.
+#include "../snake_body.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static long long checksum = 0;
+
+static double benchVector(int length, int ticks) {
+    std::vector<SnakeSegment> snake;
+    for (int i = 0; i < length; ++i) {
+        snake.push_back({-i, 0});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        SnakeSegment head = snake.front();
+        head.x += 1;
+        snake.pop_back();
+        snake.insert(snake.begin(), head);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    checksum += snake.front().x + snake.back().x;
+    return std::chrono::duration<double, std::nano>(end - start).count() / ticks;
+}
+
+static double benchRing(int length, int ticks) {
+    SnakeBody snake(length + 1);
+    for (int i = length - 1; i >= 0; --i) {
+        snake.pushHead({-i, 0});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        SnakeSegment head = snake.head();
+        head.x += 1;
+        snake.popTail();
+        snake.pushHead(head);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    checksum += snake.head().x + snake.tail().x;
+    return std::chrono::duration<double, std::nano>(end - start).count() / ticks;
+}
+
+int main() {
+    const int lengths[] = {10, 100, 1000, 10000, 100000, 1000000};
+
+    std::printf("%10s %16s %16s %10s\n", "length", "vector ns/tick", "ring ns/tick", "speedup");
+    for (int length : lengths) {
+        // Keep the vector run to roughly the same amount of memmove work per length
+        long long vectorTicks = 200000000LL / length;
+        if (vectorTicks < 200) {
+            vectorTicks = 200;
+        }
+        if (vectorTicks > 2000000) {
+            vectorTicks = 2000000;
+        }
+
+        double vectorNs = benchVector(length, static_cast<int>(vectorTicks));
+        double ringNs = benchRing(length, 20000000);
+        std::printf("%10d %16.2f %16.2f %9.1fx\n", length, vectorNs, ringNs, vectorNs / ringNs);
+    }
+
+    std::printf("checksum %lld\n", checksum);
+    return 0;
+}
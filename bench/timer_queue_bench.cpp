@@ -0,0 +1,76 @@
+// Cost per step of keeping many timed entities, with TimerQueue against
+// the per-entity countdown the bonus food used to have (every entity
+// checks its own deadline every step). Each entity re-arms with a random
+// duration whenever it fires, so the number of live timers stays fixed.
+// Runs once with short timers (up to the bonus food's 60 steps) and once
+// with long ones (up to an hour), since the heap pays per timer fired
+// while the scan pays per timer alive.
+//
+//   timer_queue_bench [steps]
+#include "../timer_queue.h"
+#include "../game.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static long long fired = 0;
+
+static double benchScan(int entities, int steps, int maxDuration, Rng& rng) {
+    std::vector<long long> deadlines(entities);
+    for (long long& deadline : deadlines) {
+        deadline = 1 + rng.below(maxDuration);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long tick = 1; tick <= steps; ++tick) {
+        for (long long& deadline : deadlines) {
+            if (deadline <= tick) {
+                ++fired;
+                deadline = tick + 1 + rng.below(maxDuration);
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / steps;
+}
+
+static double benchHeap(int entities, int steps, int maxDuration, Rng& rng) {
+    TimerQueue timers;
+    for (int i = 0; i < entities; ++i) {
+        timers.schedule(1 + rng.below(maxDuration), 0, i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    TimerQueue::Timer timer;
+    for (long long tick = 1; tick <= steps; ++tick) {
+        while (timers.popDue(tick, timer)) {
+            ++fired;
+            timers.schedule(tick + 1 + rng.below(maxDuration), timer.event, timer.target);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / steps;
+}
+
+int main(int argc, char* args[]) {
+    int steps = argc > 1 ? std::atoi(args[1]) : 20000;
+    const int counts[] = {1, 10, 100, 1000, 10000, 100000};
+
+    Rng rng;
+    rng.seed(1);
+    const int durations[] = {60, 36000};   // Steps: 6 seconds and 1 hour at 100 ms
+
+    for (int maxDuration : durations) {
+        std::printf("durations up to %d steps\n", maxDuration);
+        std::printf("%10s %16s %16s %10s\n", "timers", "scan ns/step", "heap ns/step", "speedup");
+        for (int entities : counts) {
+            double scan = benchScan(entities, steps, maxDuration, rng);
+            double heap = benchHeap(entities, steps, maxDuration, rng);
+            std::printf("%10d %16.1f %16.1f %9.1fx\n", entities, scan, heap, scan / heap);
+        }
+    }
+    std::printf("(%lld timers fired)\n", fired);
+    return 0;
+}
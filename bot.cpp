@@ -0,0 +1,112 @@
+#include "bot.h"
+
+#include <cstdlib>
+
+// Manhattan distance on a board whose edges wrap around; endless boards have none
+static int wrappedDistance(const GameState& state, SnakeSegment a, SnakeSegment b) {
+    int dx = std::abs(a.x - b.x);
+    int dy = std::abs(a.y - b.y);
+    if (state.config.endless) {
+        return dx + dy;
+    }
+    if (dx > state.config.cols - dx) {
+        dx = state.config.cols - dx;
+    }
+    if (dy > state.config.rows - dy) {
+        dy = state.config.rows - dy;
+    }
+    return dx + dy;
+}
+
+static bool isSafeMove(const GameState& state, Direction direction) {
+    if (isOpposite(direction, state.direction)) {
+        return false;
+    }
+    SnakeSegment cell = nextCell(state, state.snake.head(), direction);
+    return !isWallAt(state, cell.x, cell.y) && !isSnakeCell(state, cell.x, cell.y);
+}
+
+Direction greedyMove(const GameState& state) {
+    const SnakeSegment& head = state.snake.head();
+
+    SnakeSegment target = state.food;
+    if (state.bonusFoodActive &&
+        wrappedDistance(state, head, state.bonusFood) < wrappedDistance(state, head, state.food)) {
+        target = state.bonusFood;
+    }
+
+    // Try the current direction first so ties keep the snake going straight
+    const Direction order[] = {state.direction, UP, DOWN, LEFT, RIGHT};
+    Direction best = state.direction;
+    int bestDistance = -1;
+    for (Direction direction : order) {
+        if (!isSafeMove(state, direction)) {
+            continue;
+        }
+        int distance = wrappedDistance(state, nextCell(state, head, direction), target);
+        if (bestDistance < 0 || distance < bestDistance) {
+            best = direction;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+Direction randomMove(const GameState& state, Rng& rng) {
+    Direction safe[4];
+    int count = 0;
+    for (Direction direction : {UP, DOWN, LEFT, RIGHT}) {
+        if (isSafeMove(state, direction)) {
+            safe[count++] = direction;
+        }
+    }
+    return count > 0 ? safe[rng.below(count)] : state.direction;
+}
+
+Direction chaseMove(const GameState& state) {
+    const SnakeSegment& head = state.snake.head();
+    Direction want = state.direction;
+    if (state.food.x > head.x) {
+        want = RIGHT;
+    } else if (state.food.x < head.x) {
+        want = LEFT;
+    } else if (state.food.y > head.y) {
+        want = DOWN;
+    } else if (state.food.y < head.y) {
+        want = UP;
+    }
+    return isOpposite(want, state.direction) ? state.direction : want;
+}
+
+static Direction greedyController(const GameState& state, Rng&) {
+    return greedyMove(state);
+}
+
+static Direction chaseController(const GameState& state, Rng&) {
+    return chaseMove(state);
+}
+
+Controller findController(const std::string& name) {
+    if (name == "greedy") {
+        return greedyController;
+    }
+    if (name == "random") {
+        return randomMove;
+    }
+    if (name == "chase") {
+        return chaseController;
+    }
+    return nullptr;
+}
+
+void playGame(GameState& state, Controller controller, Rng& rng, long long stallTicks) {
+    long long lastMeal = state.ticks;
+    int lastScore = state.score;
+    while (state.result == RUNNING && state.ticks - lastMeal < stallTicks) {
+        step(state, controller(state, rng));
+        if (state.score != lastScore) {
+            lastScore = state.score;
+            lastMeal = state.ticks;
+        }
+    }
+}
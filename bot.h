@@ -0,0 +1,30 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <string>
+#include "game.h"
+
+// A controller picks the next move for one game. rng belongs to that game,
+// so a seeded run makes the same decisions on any number of threads.
+typedef Direction (*Controller)(const GameState& state, Rng& rng);
+
+// Heads for the nearest food along the shortest wrapped distance, never
+// stepping into a wall or the body when another move is available
+Direction greedyMove(const GameState& state);
+
+// Any move that does not die on the spot, chosen at random
+Direction randomMove(const GameState& state, Rng& rng);
+
+// Turns straight toward the food, horizontal first, with no safety checks.
+// This is the policy LockstepGames runs in its SIMD kernel.
+Direction chaseMove(const GameState& state);
+
+// "greedy", "random" or "chase"; nullptr for anything else
+Controller findController(const std::string& name);
+
+// Plays state to the end with controller. A bot can circle forever around
+// food it cannot reach, so the game is abandoned (result still RUNNING)
+// after stallTicks steps without eating.
+void playGame(GameState& state, Controller controller, Rng& rng, long long stallTicks);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <algorithm>
+
+// The part of the world shown in the window, in world pixels. Boards
+// larger than the window are drawn through one of these, following the
+// snake's head, so a frame only touches what is on screen.
+struct Camera {
+    int x = 0, y = 0;       // World pixel at the window's top-left corner
+    int w = 0, h = 0;       // Window size
+};
+
+// Half-open range of board cells [x0, x1) x [y0, y1)
+struct CellRange {
+    int x0, y0, x1, y1;
+};
+
+// Centers the view on (focusX, focusY) but keeps it inside the world; a
+// world smaller than the view is centered in it instead
+inline Camera followPoint(int focusX, int focusY, int worldW, int worldH, int viewW, int viewH) {
+    Camera camera;
+    camera.w = viewW;
+    camera.h = viewH;
+    camera.x = worldW <= viewW ? (worldW - viewW) / 2 : std::min(std::max(focusX - viewW / 2, 0), worldW - viewW);
+    camera.y = worldH <= viewH ? (worldH - viewH) / 2 : std::min(std::max(focusY - viewH / 2, 0), worldH - viewH);
+    return camera;
+}
+
+// Centers the view on (focusX, focusY), for worlds with no edges
+inline Camera centerOn(int focusX, int focusY, int viewW, int viewH) {
+    Camera camera;
+    camera.w = viewW;
+    camera.h = viewH;
+    camera.x = focusX - viewW / 2;
+    camera.y = focusY - viewH / 2;
+    return camera;
+}
+
+// Rounds towards minus infinity, unlike /
+inline int floorDiv(int a, int b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+// Every cell at least partly in view, with no board to clip to
+inline CellRange cellsInView(const Camera& camera, int tileSize) {
+    CellRange range;
+    range.x0 = floorDiv(camera.x, tileSize);
+    range.y0 = floorDiv(camera.y, tileSize);
+    range.x1 = floorDiv(camera.x + camera.w - 1, tileSize) + 1;
+    range.y1 = floorDiv(camera.y + camera.h - 1, tileSize) + 1;
+    return range;
+}
+
+// Every cell at least partly in view, clipped to the board
+inline CellRange visibleCells(const Camera& camera, int tileSize, int cols, int rows) {
+    CellRange range;
+    range.x0 = std::max(camera.x, 0) / tileSize;
+    range.y0 = std::max(camera.y, 0) / tileSize;
+    range.x1 = std::min((camera.x + camera.w + tileSize - 1) / tileSize, cols);
+    range.y1 = std::min((camera.y + camera.h + tileSize - 1) / tileSize, rows);
+    return range;
+}
+
+inline bool inRange(const CellRange& range, int cx, int cy) {
+    return cx >= range.x0 && cx < range.x1 && cy >= range.y0 && cy < range.y1;
+}
+
+#endif
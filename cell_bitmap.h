@@ -0,0 +1,86 @@
+#ifndef CELL_BITMAP_H
+#define CELL_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per board cell, row-major. Used to answer "is anything in this
+// cell?" in O(1) without walking the snake.
+class CellBitmap {
+public:
+    CellBitmap(int cols = 0, int rows = 0) { reset(cols, rows); }
+
+    void reset(int cols, int rows) {
+        this->cols = cols;
+        this->rows = rows;
+        words.assign((static_cast<size_t>(cols) * rows + 63) / 64, 0);
+    }
+
+    void clearAll() { words.assign(words.size(), 0); }
+
+    void set(int cx, int cy) {
+        size_t bit = index(cx, cy);
+        words[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+
+    void clear(int cx, int cy) {
+        size_t bit = index(cx, cy);
+        words[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+    }
+
+    bool test(int cx, int cy) const {
+        size_t bit = index(cx, cy);
+        return (words[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    bool inBounds(int cx, int cy) const {
+        return cx >= 0 && cy >= 0 && cx < cols && cy < rows;
+    }
+
+    int width() const { return cols; }
+    int height() const { return rows; }
+
+    // Raw 64-cell words, for comparing whole bitmaps a word at a time.
+    // Bit b of word w is cell w * 64 + b in row-major order.
+    int wordCount() const { return static_cast<int>(words.size()); }
+    uint64_t word(int w) const { return words[w]; }
+    void setWord(int w, uint64_t value) { words[w] = value; }
+
+    // Calls fn(cx) for every set cell in row cy with x0 <= cx < x1, a word
+    // at a time, so sparse rows cost little more than their width / 64
+    template <typename Fn>
+    void forEachSetInRow(int cy, int x0, int x1, Fn fn) const {
+        if (x0 >= x1) {
+            return;
+        }
+        size_t rowStart = static_cast<size_t>(cy) * cols;
+        size_t first = rowStart + x0;
+        size_t last = rowStart + x1;        // One past the end
+        for (size_t w = first >> 6; w <= (last - 1) >> 6; ++w) {
+            uint64_t bits = words[w];
+            if (w == first >> 6) {
+                bits &= ~uint64_t(0) << (first & 63);
+            }
+            if (w == (last - 1) >> 6 && (last & 63) != 0) {
+                bits &= ~(~uint64_t(0) << (last & 63));
+            }
+            while (bits) {
+                size_t bit = w * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                fn(static_cast<int>(bit - rowStart));
+            }
+        }
+    }
+
+private:
+    size_t index(int cx, int cy) const {
+        return static_cast<size_t>(cy) * cols + cx;
+    }
+
+    std::vector<uint64_t> words;
+    int cols = 0;
+    int rows = 0;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef CHUNK_WORLD_H
+#define CHUNK_WORLD_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "level.h"
+
+// Board storage for endless mode, where cell coordinates are unbounded in
+// every direction. The plane is cut into CHUNK_SIZE x CHUNK_SIZE chunks;
+// only chunks the snake is in have storage. They live in a hash map keyed
+// by chunk coordinates, come from a pool, and go back to it as soon as the
+// snake's tail leaves them, so memory follows the snake rather than how
+// far it has travelled. Walls need no storage at all: each chunk's wall is
+// worked out from its coordinates whenever it is asked for.
+const int CHUNK_SHIFT = 5;
+const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+const int CHUNK_WORDS = CHUNK_SIZE * CHUNK_SIZE / 64;
+
+// Chunk coordinates of a cell; the shift rounds towards minus infinity
+inline int chunkOf(int c) {
+    return c >> CHUNK_SHIFT;
+}
+
+class ChunkWorld {
+public:
+    // Returns every chunk to the pool, keeping the memory for the next game
+    void clear() {
+        for (const auto& entry : index) {
+            freeChunks.push_back(entry.second);
+        }
+        index.clear();
+    }
+
+    void set(int cx, int cy) {
+        Chunk& chunk = chunks[acquire(chunkOf(cx), chunkOf(cy))];
+        size_t bit = localBit(cx, cy);
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        if (!(chunk.words[bit >> 6] & mask)) {
+            chunk.words[bit >> 6] |= mask;
+            ++chunk.count;
+        }
+    }
+
+    void clear(int cx, int cy) {
+        auto found = index.find(key(chunkOf(cx), chunkOf(cy)));
+        if (found == index.end()) {
+            return;
+        }
+        Chunk& chunk = chunks[found->second];
+        size_t bit = localBit(cx, cy);
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        if (chunk.words[bit >> 6] & mask) {
+            chunk.words[bit >> 6] &= ~mask;
+            if (--chunk.count == 0) {
+                freeChunks.push_back(found->second);
+                index.erase(found);
+            }
+        }
+    }
+
+    bool test(int cx, int cy) const {
+        auto found = index.find(key(chunkOf(cx), chunkOf(cy)));
+        if (found == index.end()) {
+            return false;
+        }
+        size_t bit = localBit(cx, cy);
+        return (chunks[found->second].words[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    // Chunks holding part of the snake, and every chunk ever allocated
+    int liveChunks() const { return static_cast<int>(index.size()); }
+    int pooledChunks() const { return static_cast<int>(chunks.size()); }
+
+private:
+    struct Chunk {
+        uint64_t words[CHUNK_WORDS];
+        int count;                  // Set cells; the chunk is recycled when it drops to zero
+    };
+
+    static uint64_t key(int chunkX, int chunkY) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+    }
+
+    static size_t localBit(int cx, int cy) {
+        return static_cast<size_t>((cy & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (cx & (CHUNK_SIZE - 1)));
+    }
+
+    // Index of the chunk at these chunk coordinates, taking a cleared one
+    // from the pool if it has none yet
+    int acquire(int chunkX, int chunkY) {
+        auto inserted = index.emplace(key(chunkX, chunkY), 0);
+        if (inserted.second) {
+            if (freeChunks.empty()) {
+                chunks.emplace_back();
+                inserted.first->second = static_cast<int>(chunks.size()) - 1;
+            } else {
+                inserted.first->second = freeChunks.back();
+                freeChunks.pop_back();
+            }
+            chunks[inserted.first->second] = Chunk{};
+        }
+        return inserted.first->second;
+    }
+
+    std::unordered_map<uint64_t, int> index;
+    std::vector<Chunk> chunks;      // The pool; indices stay valid as it grows
+    std::vector<int> freeChunks;
+};
+
+// The wall in a chunk, in cell coordinates: a single bar of 8 to 24 cells
+// inside the chunk, or none for about a quarter of chunks and for the
+// chunks around the origin, where the snake starts. Derived from the chunk
+// coordinates alone, so every game on an endless board has the same layout.
+inline bool chunkWall(int chunkX, int chunkY, WallRect& wall) {
+    if (chunkX >= -1 && chunkX <= 1 && chunkY >= -1 && chunkY <= 1) {
+        return false;
+    }
+
+    // splitmix64 finalizer over the chunk's key
+    uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    if ((h & 3) == 0) {
+        return false;
+    }
+
+    int length = 8 + static_cast<int>((h >> 3) % 17);
+    int along = static_cast<int>((h >> 8) % (CHUNK_SIZE - length + 1));
+    int across = static_cast<int>((h >> 16) % CHUNK_SIZE);
+    bool horizontal = (h >> 2) & 1;
+    wall.x = chunkX * CHUNK_SIZE + (horizontal ? along : across);
+    wall.y = chunkY * CHUNK_SIZE + (horizontal ? across : along);
+    wall.w = horizontal ? length : 1;
+    wall.h = horizontal ? 1 : length;
+    return true;
+}
+
+inline bool isChunkWallCell(int cx, int cy) {
+    WallRect wall;
+    return chunkWall(chunkOf(cx), chunkOf(cy), wall) && cx >= wall.x && cx < wall.x + wall.w && cy >= wall.y &&
+           cy < wall.y + wall.h;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef DIRECTION_BODY_H
+#define DIRECTION_BODY_H
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "run_body.h"
+
+// The snake as its head and tail cells plus the move between every pair of
+// neighbouring segments, two bits each (up, down, left, right, in the order
+// of the game's Direction enum), in a growable circular bit buffer. That is
+// 2 bits per segment against 8 bytes for a SnakeSegment, for running very
+// many games at once. Coordinates are rebuilt on the fly by walking the
+// moves back from the head.
+//
+// Pushing a head appends one move and dropping the tail consumes the
+// oldest one, both O(1). On a wrapping board the buffer needs the board
+// size to tell a wrapped move from a plain one and to wrap coordinates
+// as it rebuilds them; setBoard(0, 0) means an endless board.
+class DirectionBody {
+public:
+    explicit DirectionBody(int capacity = 64) { reset(capacity); }
+
+    // Sizes the buffer for capacity moves, rounded up to a power of two;
+    // it doubles whenever it fills up
+    void reset(int capacity) {
+        int entries = static_cast<int>(MOVES_PER_WORD);
+        while (entries < capacity) {
+            entries *= 2;
+        }
+        words.assign(entries / MOVES_PER_WORD, 0);
+        mask = entries - 1;
+        clear();
+    }
+
+    void clear() {
+        oldest = 0;
+        moves = 0;
+        cells = 0;
+    }
+
+    void setBoard(int cols, int rows) {
+        this->cols = cols;
+        this->rows = rows;
+    }
+
+    void pushHead(SnakeSegment cell) {
+        if (cells == 0) {
+            headCell = cell;
+            tailCell = cell;
+            cells = 1;
+            return;
+        }
+        if (moves == capacity()) {
+            grow();
+        }
+        write((oldest + moves) & mask, moveBetween(headCell, cell));
+        ++moves;
+        ++cells;
+        headCell = cell;
+    }
+
+    void popTail() {
+        assert(cells > 0);
+        --cells;
+        if (moves == 0) {
+            return;
+        }
+        tailCell = step(tailCell, read(oldest), 1);
+        oldest = (oldest + 1) & mask;
+        --moves;
+    }
+
+    const SnakeSegment& head() const { return headCell; }
+    const SnakeSegment& tail() const { return tailCell; }
+
+    int size() const { return cells; }
+    bool empty() const { return cells == 0; }
+    int capacity() const { return static_cast<int>(mask) + 1; }
+
+    // Calls fn(SnakeSegment) for every cell, head first
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        if (cells == 0) {
+            return;
+        }
+        SnakeSegment cell = headCell;
+        fn(cell);
+        for (int i = moves - 1; i >= 0; --i) {
+            cell = step(cell, read((oldest + i) & mask), -1);
+            fn(cell);
+        }
+    }
+
+    // Calls fn(const SnakeRun&) for every straight run, head first, so the
+    // snapshot and renderer can draw it the same way as a RunBody
+    template <typename Fn>
+    void forEachRun(Fn fn) const {
+        if (cells == 0) {
+            return;
+        }
+        SnakeRun run = {headCell, headCell, 0, 0};
+        for (int i = moves - 1; i >= 0; --i) {
+            int move = read((oldest + i) & mask);
+            SnakeSegment previous = step(run.tail, move, -1);
+            bool wrapped = std::abs(previous.x - run.tail.x) + std::abs(previous.y - run.tail.y) != 1;
+            bool single = run.head.x == run.tail.x && run.head.y == run.tail.y;
+            if (!wrapped && (single || (MOVE_X[move] == run.dx && MOVE_Y[move] == run.dy))) {
+                run.tail = previous;
+                run.dx = MOVE_X[move];
+                run.dy = MOVE_Y[move];
+            } else {
+                fn(run);
+                run = {previous, previous, 0, 0};
+            }
+        }
+        fn(run);
+    }
+
+private:
+    static const unsigned MOVES_PER_WORD = 32;
+    static constexpr int MOVE_X[4] = {0, 0, -1, 1};
+    static constexpr int MOVE_Y[4] = {-1, 1, 0, 0};
+
+    int read(unsigned index) const {
+        return static_cast<int>((words[index / MOVES_PER_WORD] >> (2 * (index % MOVES_PER_WORD))) & 3);
+    }
+
+    void write(unsigned index, int move) {
+        uint64_t& word = words[index / MOVES_PER_WORD];
+        unsigned shift = 2 * (index % MOVES_PER_WORD);
+        word = (word & ~(uint64_t(3) << shift)) | (static_cast<uint64_t>(move) << shift);
+    }
+
+    // The move from one cell to its neighbour, across the board edge if need be
+    int moveBetween(SnakeSegment from, SnakeSegment to) const {
+        int dx = to.x - from.x;
+        int dy = to.y - from.y;
+        if (dx != 0) {
+            return (dx == 1 || dx == -(cols - 1)) ? 3 : 2;
+        }
+        return (dy == 1 || dy == -(rows - 1)) ? 1 : 0;
+    }
+
+    // cell moved by sign times the move, wrapped onto the board if it has edges
+    SnakeSegment step(SnakeSegment cell, int move, int sign) const {
+        cell.x += sign * MOVE_X[move];
+        cell.y += sign * MOVE_Y[move];
+        if (cols > 0) {
+            cell.x = cell.x < 0 ? cols - 1 : (cell.x >= cols ? 0 : cell.x);
+            cell.y = cell.y < 0 ? rows - 1 : (cell.y >= rows ? 0 : cell.y);
+        }
+        return cell;
+    }
+
+    // Doubles the buffer, unwrapping it so the oldest move is back at 0
+    void grow() {
+        DirectionBody larger(capacity() * 2);
+        for (int i = 0; i < moves; ++i) {
+            larger.write(i, read((oldest + i) & mask));
+        }
+        words.swap(larger.words);
+        mask = larger.mask;
+        oldest = 0;
+    }
+
+    std::vector<uint64_t> words;
+    unsigned mask = 0;              // Capacity in moves, less one
+    unsigned oldest = 0;            // Buffer index of the move out of the tail cell
+    int moves = 0;                  // Always cells - 1 once there is a cell
+    int cells = 0;
+    SnakeSegment headCell = {0, 0}, tailCell = {0, 0};
+    int cols = 0, rows = 0;         // 0 for a board with no edges
+};
+
+#endif
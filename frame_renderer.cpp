@@ -0,0 +1,282 @@
+#include "frame_renderer.h"
+
+#include <cstdlib>
+#include "camera.h"
+#include "profiler.h"
+
+// One layer per color, in the order the game screen has always drawn them
+void initFrameRenderer(FrameRenderer& frame, SDL_Renderer* renderer, int width, int height, int tileSize,
+                       GlyphAtlas* textAtlas) {
+    frame.renderer = renderer;
+    frame.width = width;
+    frame.height = height;
+    frame.tileSize = tileSize;
+    frame.textAtlas = textAtlas;
+
+    frame.shapes.layers.clear();
+    frame.borderLayer = addRectLayer(frame.shapes, {0, 128, 128, 0});
+    frame.wallLayer = addRectLayer(frame.shapes, {128, 0, 128, 255});
+    frame.snakeLayer = addRectLayer(frame.shapes, {85, 107, 47, 255});
+    frame.foodLayer = addRectLayer(frame.shapes, {255, 0, 0, 255});
+    frame.bonusFoodLayer = addRectLayer(frame.shapes, {0, 0, 255, 255});
+}
+
+static void destroyBackground(FrameRenderer& frame) {
+    if (frame.backgroundTexture) {
+        SDL_DestroyTexture(frame.backgroundTexture);
+        frame.backgroundTexture = nullptr;
+    }
+}
+
+void destroyFrameRenderer(FrameRenderer& frame) {
+    destroySceneCache(frame.scene);
+    destroyBackground(frame);
+}
+
+// The incremental mode's texture, in the same colors as the full frame path
+bool createScene(FrameRenderer& frame) {
+    destroySceneCache(frame.scene);
+    return createSceneCache(frame.renderer, frame.scene, frame.width, frame.height, frame.tileSize,
+                            frame.shapes.layers[frame.snakeLayer].color, frame.shapes.layers[frame.foodLayer].color,
+                            frame.shapes.layers[frame.bonusFoodLayer].color);
+}
+
+void invalidateBackground(FrameRenderer& frame) {
+    destroyBackground(frame);
+    frame.backgroundDirty = true;
+}
+
+// Everything static on the game screen: the border and the level's walls
+static void queueBackground(FrameRenderer& frame, const Level& level) {
+    const int tile = frame.tileSize;
+    queueRect(frame.shapes, frame.borderLayer, {0, 0, frame.width, tile});
+    queueRect(frame.shapes, frame.borderLayer, {0, frame.height - tile, frame.width, tile});
+    queueRect(frame.shapes, frame.borderLayer, {0, 0, tile, frame.height});
+    queueRect(frame.shapes, frame.borderLayer, {frame.width - tile, 0, tile, frame.height});
+
+    for (const WallRect& wall : level.walls) {
+        queueRect(frame.shapes, frame.wallLayer, {wall.x, wall.y, wall.w, wall.h});
+    }
+}
+
+// Redraws the background texture if it was invalidated. Returns false if
+// the renderer cannot draw into textures, in which case the caller draws
+// the background itself.
+static bool updateBackground(FrameRenderer& frame, const Level& level) {
+    if (frame.backgroundDirty) {
+        frame.backgroundDirty = false;
+        if (!frame.backgroundTexture && SDL_RenderTargetSupported(frame.renderer)) {
+            frame.backgroundTexture = SDL_CreateTexture(frame.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                                        SDL_TEXTUREACCESS_TARGET, frame.width, frame.height);
+        }
+        if (!frame.backgroundTexture) {
+            return false;
+        }
+
+        // The border color has zero alpha, so copy the texture as is rather than blending it
+        SDL_SetTextureBlendMode(frame.backgroundTexture, SDL_BLENDMODE_NONE);
+        SDL_SetRenderTarget(frame.renderer, frame.backgroundTexture);
+        SDL_SetRenderDrawColor(frame.renderer, 0, 0, 0, 255);
+        SDL_RenderClear(frame.renderer);
+        queueBackground(frame, level);
+        flushRects(frame.renderer, frame.shapes);
+        SDL_SetRenderTarget(frame.renderer, nullptr);
+
+        // The scene was built on top of the old background
+        invalidateSceneCache(frame.scene);
+    }
+    return frame.backgroundTexture != nullptr;
+}
+
+// The food and bonus food if they are in range, shifted into window coordinates
+static void queueFood(FrameRenderer& frame, const GameSnapshot& view, const Camera& camera, const CellRange& range) {
+    const int tile = frame.tileSize;
+    if (inRange(range, view.food.x, view.food.y)) {
+        queueRect(frame.shapes, frame.foodLayer,
+                  {view.food.x * tile - camera.x, view.food.y * tile - camera.y, tile, tile});
+    }
+    if (view.bonusFoodActive && inRange(range, view.bonusFood.x, view.bonusFood.y)) {
+        queueRect(frame.shapes, frame.bonusFoodLayer,
+                  {view.bonusFood.x * tile - camera.x, view.bonusFood.y * tile - camera.y, tile, tile});
+    }
+}
+
+// One rect per straight run of the body that is in view, however long the
+// run. The head cell is left out; renderFrame() draws it sliding into place.
+static void queueBody(FrameRenderer& frame, const GameSnapshot& view, const Camera& camera) {
+    const int tile = frame.tileSize;
+    const SDL_Rect viewport = {camera.x, camera.y, camera.w, camera.h};
+    for (size_t i = 0; i < view.runs.size(); ++i) {
+        SnakeRun run = view.runs[i];
+        if (i == 0) {
+            if (run.head.x == run.tail.x && run.head.y == run.tail.y) {
+                continue;
+            }
+            run.head = runCell(run, 1);
+        }
+        int x, y, w, h;
+        runBounds(run, x, y, w, h);
+        SDL_Rect rect = {x * tile, y * tile, w * tile, h * tile};
+        if (SDL_HasIntersection(&rect, &viewport)) {
+            queueRect(frame.shapes, frame.snakeLayer, {rect.x - camera.x, rect.y - camera.y, rect.w, rect.h});
+        }
+    }
+}
+
+// Everything in view on a board drawn through the camera, shifted into
+// window coordinates. Walls are few and tested one by one, and the body is
+// culled run by run, so the board size does not change the cost of a frame.
+static void queueVisibleWorld(FrameRenderer& frame, const GameState& game, const GameSnapshot& view,
+                              const Camera& camera) {
+    const int tile = frame.tileSize;
+    const SDL_Rect viewport = {camera.x, camera.y, camera.w, camera.h};
+    auto queueInView = [&frame, &viewport, &camera](int layer, const SDL_Rect& rect) {
+        if (SDL_HasIntersection(&rect, &viewport)) {
+            queueRect(frame.shapes, layer, {rect.x - camera.x, rect.y - camera.y, rect.w, rect.h});
+        }
+    };
+
+    int worldW = game.config.cols * tile;
+    int worldH = game.config.rows * tile;
+    queueInView(frame.borderLayer, {0, 0, worldW, tile});
+    queueInView(frame.borderLayer, {0, worldH - tile, worldW, tile});
+    queueInView(frame.borderLayer, {0, 0, tile, worldH});
+    queueInView(frame.borderLayer, {worldW - tile, 0, tile, worldH});
+    for (const WallRect& wall : game.level.walls) {
+        queueInView(frame.wallLayer, {wall.x, wall.y, wall.w, wall.h});
+    }
+
+    queueBody(frame, view, camera);
+    queueFood(frame, view, camera, visibleCells(camera, tile, game.config.cols, game.config.rows));
+}
+
+// Everything in view on an endless board. Each chunk has at most one wall,
+// worked out from its coordinates, so walls cost one rect per visible
+// chunk; the body is culled run by run as on any other board.
+static void queueEndlessWorld(FrameRenderer& frame, const GameSnapshot& view, const Camera& camera) {
+    const int tile = frame.tileSize;
+    CellRange range = cellsInView(camera, tile);
+    for (int chunkY = chunkOf(range.y0); chunkY <= chunkOf(range.y1 - 1); ++chunkY) {
+        for (int chunkX = chunkOf(range.x0); chunkX <= chunkOf(range.x1 - 1); ++chunkX) {
+            WallRect wall;
+            if (chunkWall(chunkX, chunkY, wall)) {
+                queueRect(frame.shapes, frame.wallLayer, {wall.x * tile - camera.x, wall.y * tile - camera.y,
+                                                          wall.w * tile, wall.h * tile});
+            }
+        }
+    }
+
+    queueBody(frame, view, camera);
+    queueFood(frame, view, camera, range);
+}
+
+void renderFrame(FrameRenderer& frame, const GameState& game, const GameSnapshot& view, float alpha) {
+    PROFILE_ZONE("render");
+    const int tile = frame.tileSize;
+
+    // Slide the head from its previous cell towards the current one; a move
+    // that wrapped around the screen edge is drawn where it landed
+    const SnakeSegment& head = view.runs.front().head;
+    const SnakeSegment& previousHead = view.previousHead;
+    int headX = head.x * tile;
+    int headY = head.y * tile;
+    if (std::abs(head.x - previousHead.x) + std::abs(head.y - previousHead.y) == 1) {
+        headX = previousHead.x * tile + static_cast<int>((head.x - previousHead.x) * tile * alpha);
+        headY = previousHead.y * tile + static_cast<int>((head.y - previousHead.y) * tile * alpha);
+    }
+
+    if (frame.followCamera) {
+        Camera camera;
+        SDL_SetRenderDrawColor(frame.renderer, 0, 0, 0, 255);
+        SDL_RenderClear(frame.renderer);
+        if (game.config.endless) {
+            camera = centerOn(headX + tile / 2, headY + tile / 2, frame.width, frame.height);
+            queueEndlessWorld(frame, view, camera);
+        } else {
+            camera = followPoint(headX + tile / 2, headY + tile / 2, game.config.cols * tile,
+                                 game.config.rows * tile, frame.width, frame.height);
+            queueVisibleWorld(frame, game, view, camera);
+        }
+        headX -= camera.x;
+        headY -= camera.y;
+    } else {
+        // Either cached texture covers the whole screen, so copying it doubles as the clear
+        bool haveBackground = updateBackground(frame, game.level);
+        if (frame.incremental && haveBackground) {
+            updateSceneCache(frame.renderer, frame.scene, view, frame.backgroundTexture);
+            SDL_RenderCopy(frame.renderer, frame.scene.texture, nullptr, nullptr);
+        } else {
+            if (haveBackground) {
+                SDL_RenderCopy(frame.renderer, frame.backgroundTexture, nullptr, nullptr);
+            } else {
+                SDL_SetRenderDrawColor(frame.renderer, 0, 0, 0, 255);
+                SDL_RenderClear(frame.renderer);
+                queueBackground(frame, game.level);
+            }
+
+            Camera window;
+            window.w = frame.width;
+            window.h = frame.height;
+            queueBody(frame, view, window);
+            queueFood(frame, view, window, {0, 0, game.config.cols, game.config.rows});
+        }
+    }
+    queueRect(frame.shapes, frame.snakeLayer, {headX, headY, tile, tile});
+
+    // A handful of draw calls however long the snake is
+    flushRects(frame.renderer, frame.shapes);
+
+    SDL_Color textColor = {255, 255, 255, 255};
+    std::string scoreText = "Score: " + std::to_string(view.score);
+
+    // Render score
+    queueString(frame, scoreText, 10, 10, textColor);
+
+    // Render level board (you can customize it based on your game's logic)
+    std::string levelText = "Level: 1"; // Customize based on your game's logic
+    queueString(frame, levelText, frame.width - measureString(frame, levelText, textColor) - 10, 10, textColor);
+
+    // Both strings go out in a single batched draw
+    flushStrings(frame);
+
+    {
+        PROFILE_ZONE("present");
+        SDL_RenderPresent(frame.renderer);
+    }
+}
+
+// Sleeping the whole way, rather than spinning out the last couple of
+// milliseconds, keeps the CPU idle between frames; the odd late wakeup
+// only delays one frame by about as much
+void waitForFrameDeadline(Uint64 deadline) {
+    PROFILE_ZONE("frame wait");
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now < deadline) {
+        // Rounded up to a whole millisecond so the wait cannot end early
+        SDL_Delay(static_cast<Uint32>(((deadline - now) * 1000 + counterFrequency - 1) / counterFrequency));
+    }
+}
+
+int measureString(FrameRenderer& frame, const std::string& text, SDL_Color color) {
+    if (frame.textCache) {
+        return measureCachedText(frame.renderer, *frame.textCache, text, color);
+    }
+    return measureText(*frame.textAtlas, text);
+}
+
+void queueString(FrameRenderer& frame, const std::string& text, int x, int y, SDL_Color color) {
+    PROFILE_ZONE("text");
+    if (frame.textCache) {
+        drawCachedText(frame.renderer, *frame.textCache, text, x, y, color);
+    } else {
+        queueText(*frame.textAtlas, text, x, y, color);
+    }
+}
+
+void flushStrings(FrameRenderer& frame) {
+    PROFILE_ZONE("text");
+    if (!frame.textCache) {
+        flushText(frame.renderer, *frame.textAtlas);
+    }
+}
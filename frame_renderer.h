@@ -0,0 +1,75 @@
+#ifndef FRAME_RENDERER_H
+#define FRAME_RENDERER_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include "game.h"
+#include "glyph_atlas.h"
+#include "rect_batch.h"
+#include "scene_cache.h"
+#include "snapshot.h"
+#include "text_cache.h"
+
+// Draws the game screen from a snapshot: the border and walls from a
+// cached background texture, the body and food batched one draw call per
+// color, the head eased between cells, and the score. Boards that are not
+// exactly the window, or have no edges, are drawn through a camera
+// following the head instead. Kept apart from main.cpp's window and menus
+// so benchmarks can time the same frames the game draws.
+struct FrameRenderer {
+    SDL_Renderer* renderer = nullptr;
+    int width = 0, height = 0;      // Window size in pixels
+    int tileSize = 1;
+
+    // All text goes through the glyph atlas, or through textCache when it
+    // is set (--text-cache)
+    GlyphAtlas* textAtlas = nullptr;
+    TextCache* textCache = nullptr;
+
+    // Everything a frame fills is queued here and drawn with one call per color
+    RectBatch shapes;
+    int borderLayer = 0, wallLayer = 0, snakeLayer = 0, foodLayer = 0, bonusFoodLayer = 0;
+
+    // Border and walls drawn once into a texture; rebuilt only after invalidateBackground()
+    SDL_Texture* backgroundTexture = nullptr;
+    bool backgroundDirty = true;
+
+    // Incremental mode (--incremental) keeps the body and food in a texture and
+    // repaints only the cells that changed; handy on software renderers
+    bool incremental = false;
+    SceneCache scene;
+
+    // Draw through a camera following the head, culled to the cells in view
+    bool followCamera = false;
+};
+
+void initFrameRenderer(FrameRenderer& frame, SDL_Renderer* renderer, int width, int height, int tileSize,
+                       GlyphAtlas* textAtlas);
+
+// Destroys the background and scene textures; call before the renderer goes away
+void destroyFrameRenderer(FrameRenderer& frame);
+
+// (Re)creates the incremental mode's texture. Returns false if the
+// renderer cannot draw into textures.
+bool createScene(FrameRenderer& frame);
+
+// Call when the level changes or the texture's contents may have been lost
+void invalidateBackground(FrameRenderer& frame);
+
+// Draws and presents one snapshot of game; alpha is how far (0..1) the
+// simulation is between that step and the next. Only the config and level
+// are read from game, which do not change once initGame() has run.
+void renderFrame(FrameRenderer& frame, const GameState& game, const GameSnapshot& view, float alpha);
+
+// Paces frames when vsync does not: sleeps until the performance counter
+// reaches deadline. Wakes up to a millisecond or so late, but never early.
+void waitForFrameDeadline(Uint64 deadline);
+
+// Every text draw site goes through these three, so --text-cache can swap
+// the glyph atlas for whole-string textures. The cache draws straight
+// away; the atlas batches until flushStrings().
+int measureString(FrameRenderer& frame, const std::string& text, SDL_Color color);
+void queueString(FrameRenderer& frame, const std::string& text, int x, int y, SDL_Color color);
+void flushStrings(FrameRenderer& frame);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef FREE_CELLS_H
+#define FREE_CELLS_H
+
+#include <cstddef>
+#include <vector>
+
+// Set of cell indices with O(1) insert, erase and uniform sampling.
+// cells holds the members densely; position maps a cell back to its slot
+// in cells (or -1), so erase can swap the last member into the hole.
+//
+// checkpoint() starts an undo log of every insert and erase, which
+// rollback() replays backwards to put the set back exactly as it was,
+// member order included. That costs as much as the changes since, not the
+// size of the set. The log is capped at a quarter of the cell count; past
+// that it is dropped and rollback() fails, leaving the caller to rebuild.
+class FreeCellSet {
+public:
+    explicit FreeCellSet(int cellCount = 0) { reset(cellCount); }
+
+    // Empties the set and sizes it for cells [0, cellCount); ends any checkpoint
+    void reset(int cellCount) {
+        cells.clear();
+        cells.reserve(cellCount);
+        position.assign(cellCount, -1);
+        log.clear();
+        logging = false;
+    }
+
+    void checkpoint() {
+        log.clear();
+        logging = true;
+    }
+
+    // Undoes everything since checkpoint(), which stays in force. Returns
+    // false, changing nothing, if there is no checkpoint or the log overflowed.
+    bool rollback() {
+        if (!logging) {
+            return false;
+        }
+        for (size_t i = log.size(); i-- > 0;) {
+            const Change& change = log[i];
+            if (change.slot < 0) {
+                // Inserted at the end, which it is again now
+                position[change.cell] = -1;
+                cells.pop_back();
+            } else if (change.slot == size()) {
+                // Erased from the end
+                position[change.cell] = change.slot;
+                cells.push_back(change.cell);
+            } else {
+                // Erased from the middle: move the member that filled the hole back to the end
+                int moved = cells[change.slot];
+                position[moved] = size();
+                cells.push_back(moved);
+                position[change.cell] = change.slot;
+                cells[change.slot] = change.cell;
+            }
+        }
+        log.clear();
+        return true;
+    }
+
+    void insert(int cell) {
+        if (position[cell] >= 0) {
+            return;
+        }
+        record(cell, -1);
+        position[cell] = static_cast<int>(cells.size());
+        cells.push_back(cell);
+    }
+
+    void erase(int cell) {
+        int slot = position[cell];
+        if (slot < 0) {
+            return;
+        }
+        record(cell, slot);
+        int last = cells.back();
+        cells[slot] = last;
+        position[last] = slot;
+        cells.pop_back();
+        position[cell] = -1;
+    }
+
+    bool contains(int cell) const { return position[cell] >= 0; }
+
+    int size() const { return static_cast<int>(cells.size()); }
+    bool empty() const { return cells.empty(); }
+
+    // Member i in arbitrary order; at(uniform(0, size() - 1)) is a uniform draw
+    int at(int i) const { return cells[i]; }
+
+private:
+    // An insert of cell (slot -1), or its erase from slot
+    struct Change {
+        int cell;
+        int slot;
+    };
+
+    void record(int cell, int slot) {
+        if (!logging) {
+            return;
+        }
+        if (log.size() >= position.size() / 4) {
+            log.clear();
+            logging = false;
+            return;
+        }
+        log.push_back({cell, slot});
+    }
+
+    std::vector<int> cells;
+    std::vector<int> position;
+    std::vector<Change> log;
+    bool logging = false;
+};
+
+#endif
@@ -0,0 +1,341 @@
+#include "game.h"
+
+// SnakeBody's starting ring; pushSnakeHead() doubles it when the snake fills it
+const int INITIAL_BODY_CAPACITY = 64;
+
+static int cellIndex(const GameState& state, int cx, int cy) {
+    return cy * state.config.cols + cx;
+}
+
+// Food goes anywhere inside the border that is not a wall
+static bool isSpawnCell(const GameState& state, int cx, int cy) {
+    return cx > 0 && cy > 0 && cx < state.config.cols - 1 && cy < state.config.rows - 1 &&
+           !isWallCell(state.level, cx, cy);
+}
+
+static void pushSnakeHead(GameState& state, SnakeSegment head) {
+#if !defined(SNAKE_PACKED_BODY) && !defined(SNAKE_RUN_BODY)
+    // The segment ring starts small and doubles as the snake outgrows it
+    if (state.snake.size() == state.snake.capacity()) {
+        state.snake.grow();
+    }
+#endif
+    state.snake.pushHead(head);
+    if (state.config.endless) {
+        state.world.set(head.x, head.y);
+        return;
+    }
+    state.snakeCells.set(head.x, head.y);
+    state.freeCells.erase(cellIndex(state, head.x, head.y));
+}
+
+static void popSnakeTail(GameState& state) {
+    SnakeSegment tail = state.snake.tail();
+    if (state.config.endless) {
+        state.world.clear(tail.x, tail.y);
+    } else {
+        state.snakeCells.clear(tail.x, tail.y);
+        if (isSpawnCell(state, tail.x, tail.y)) {
+            state.freeCells.insert(cellIndex(state, tail.x, tail.y));
+        }
+    }
+    state.snake.popTail();
+}
+
+// Rebuilds freeCells from scratch after the level or the snake changed wholesale
+static void resetFreeCells(GameState& state) {
+    const GameConfig& config = state.config;
+    if (config.endless) {
+        state.freeCells.reset(0);
+        return;
+    }
+    state.freeCells.reset(config.cols * config.rows);
+    for (int cy = 0; cy < config.rows; ++cy) {
+        for (int cx = 0; cx < config.cols; ++cx) {
+            if (isSpawnCell(state, cx, cy) && !state.snakeCells.test(cx, cy)) {
+                state.freeCells.insert(cellIndex(state, cx, cy));
+            }
+        }
+    }
+}
+
+// One uniform draw over the free cells, skipping excludedCell (-1 for none)
+static bool drawFreeCell(GameState& state, int excludedCell, SnakeSegment& cell) {
+    bool excluded = excludedCell >= 0 && state.freeCells.contains(excludedCell);
+    if (excluded) {
+        state.freeCells.erase(excludedCell);
+    }
+
+    bool found = !state.freeCells.empty();
+    if (found) {
+        int index = state.freeCells.at(state.rng.below(state.freeCells.size()));
+        cell.x = index % state.config.cols;
+        cell.y = index / state.config.cols;
+    }
+
+    if (excluded) {
+        state.freeCells.insert(excludedCell);
+    }
+    return found;
+}
+
+static bool isOpenCellNearHead(const GameState& state, const SnakeSegment* excluded, SnakeSegment cell) {
+    return !isChunkWallCell(cell.x, cell.y) && !state.world.test(cell.x, cell.y) &&
+           !(excluded && excluded->x == cell.x && excluded->y == cell.y);
+}
+
+// Endless boards have no free-cell list to draw from; food goes on a
+// random open cell in the cols x rows window around the head instead.
+// Rejection sampling: with the window mostly open the first draw or two
+// lands. When the snake has coiled over the window and every try misses,
+// the rings of cells around the head are searched outward, nearest first.
+// The snake and the walls are finite, so that always finds a cell.
+static void drawOpenCellNearHead(GameState& state, const SnakeSegment* excluded, SnakeSegment& cell) {
+    const int MAX_TRIES = 64;
+    const SnakeSegment head = state.snake.head();
+    for (int i = 0; i < MAX_TRIES; ++i) {
+        SnakeSegment candidate = {head.x - state.config.cols / 2 + state.rng.below(state.config.cols),
+                                  head.y - state.config.rows / 2 + state.rng.below(state.config.rows)};
+        if (isOpenCellNearHead(state, excluded, candidate)) {
+            cell = candidate;
+            return;
+        }
+    }
+
+    for (int r = 1;; ++r) {
+        // Top and bottom rows of the ring, then the columns between them
+        for (int dx = -r; dx <= r; ++dx) {
+            for (int dy : {-r, r}) {
+                if (isOpenCellNearHead(state, excluded, {head.x + dx, head.y + dy})) {
+                    cell = {head.x + dx, head.y + dy};
+                    return;
+                }
+            }
+        }
+        for (int dy = -r + 1; dy < r; ++dy) {
+            for (int dx : {-r, r}) {
+                if (isOpenCellNearHead(state, excluded, {head.x + dx, head.y + dy})) {
+                    cell = {head.x + dx, head.y + dy};
+                    return;
+                }
+            }
+        }
+    }
+}
+
+bool spawnFood(GameState& state) {
+    if (state.config.endless) {
+        drawOpenCellNearHead(state, state.bonusFoodActive ? &state.bonusFood : nullptr, state.food);
+        return true;
+    }
+    int excludedCell = state.bonusFoodActive ? cellIndex(state, state.bonusFood.x, state.bonusFood.y) : -1;
+    return drawFreeCell(state, excludedCell, state.food);
+}
+
+bool spawnBonusFood(GameState& state) {
+    if (state.config.endless) {
+        drawOpenCellNearHead(state, &state.food, state.bonusFood);
+    } else if (!drawFreeCell(state, cellIndex(state, state.food.x, state.food.y), state.bonusFood)) {
+        return false;
+    }
+
+    // A bonus food that replaces one still on the board gets a fresh timer
+    state.timers.cancel(state.bonusFoodTimer);
+    state.bonusFoodActive = true;
+    state.bonusFoodTimer = state.timers.schedule(state.ticks + ticksFor(state.config, state.config.bonusDurationMs),
+                                                 BONUS_FOOD_EXPIRES);
+    return true;
+}
+
+static void removeBonusFood(GameState& state) {
+    state.timers.cancel(state.bonusFoodTimer);
+    state.bonusFoodTimer = -1;
+    state.bonusFoodActive = false;
+}
+
+// Fires every timer due this step, earliest first
+static void runTimers(GameState& state) {
+    TimerQueue::Timer timer;
+    while (state.timers.popDue(state.ticks, timer)) {
+        switch (timer.event) {
+            case BONUS_FOOD_EXPIRES:
+                state.bonusFoodTimer = -1;
+                state.bonusFoodActive = false;
+                spawnFood(state);
+                break;
+        }
+    }
+}
+
+void initGame(GameState& state, const GameConfig& config, uint64_t seed) {
+    state.config = config;
+#if defined(SNAKE_PACKED_BODY)
+    state.snake.setBoard(config.endless ? 0 : config.cols, config.endless ? 0 : config.rows);
+#elif !defined(SNAKE_RUN_BODY)
+    state.snake.reset(INITIAL_BODY_CAPACITY);
+#endif
+    // The last game's free cells were laid out for the old board
+    state.freeCells.reset(0);
+    if (config.endless) {
+        // Walls come from chunkWall() and the snake lives in world
+        loadLevel(state.level, {}, 0, 0, config.tileSize);
+        state.snakeCells.reset(0, 0);
+        resetGame(state, seed);
+        return;
+    }
+    loadLevel(state.level, config.walls, config.cols, config.rows, config.tileSize);
+
+    state.snakeCells.reset(config.cols, config.rows);
+
+    resetGame(state, seed);
+}
+
+void resetGame(GameState& state, uint64_t seed) {
+    // Food is drawn by position in freeCells, so its order must not depend
+    // on earlier games or replays would diverge. Rolling back to the
+    // checkpoint taken at the last reset gives exactly the order a rebuild
+    // would, touching only the cells the last game changed.
+    state.snake.clear();
+    state.snakeCells.clearAll();
+    state.world.clear();
+    if (!state.freeCells.rollback()) {
+        resetFreeCells(state);
+        state.freeCells.checkpoint();
+    }
+    if (state.config.endless) {
+        pushSnakeHead(state, {0, 0});       // Chunks around the origin have no walls
+    } else {
+        pushSnakeHead(state, {state.config.cols / 2, state.config.rows / 2});
+    }
+    state.previousHead = state.snake.head();
+
+    state.rng.seed(seed);
+    state.direction = RIGHT;
+    state.score = 0;
+    state.regularFoodEaten = 0;
+    state.bonusFoodActive = false;
+    state.bonusFoodTimer = -1;
+    state.timers.clear();
+    state.ticks = 0;
+    state.timeMs = 0;
+    state.result = RUNNING;
+
+    spawnFood(state);
+}
+
+long long ticksFor(const GameConfig& config, int ms) {
+    return (static_cast<long long>(ms) + config.stepMs - 1) / config.stepMs;
+}
+
+bool isOpposite(Direction a, Direction b) {
+    return (a == UP && b == DOWN) || (a == DOWN && b == UP) ||
+           (a == LEFT && b == RIGHT) || (a == RIGHT && b == LEFT);
+}
+
+bool isSnakeCell(const GameState& state, int cx, int cy) {
+    return state.config.endless ? state.world.test(cx, cy) : state.snakeCells.test(cx, cy);
+}
+
+// Single lookup into the rasterized level, however many walls it has
+bool isWallAt(const GameState& state, int cx, int cy) {
+    return state.config.endless ? isChunkWallCell(cx, cy) : isWallCell(state.level, cx, cy);
+}
+
+// The cell one move away, wrapping around the board edges unless it is endless
+SnakeSegment nextCell(const GameState& state, SnakeSegment cell, Direction direction) {
+    switch (direction) {
+        case UP:
+            cell.y -= 1;
+            break;
+        case DOWN:
+            cell.y += 1;
+            break;
+        case LEFT:
+            cell.x -= 1;
+            break;
+        case RIGHT:
+            cell.x += 1;
+            break;
+    }
+    if (state.config.endless) {
+        return cell;
+    }
+
+    if (cell.x < 0) {
+        cell.x = state.config.cols - 1;
+    } else if (cell.x >= state.config.cols) {
+        cell.x = 0;
+    }
+
+    if (cell.y < 0) {
+        cell.y = state.config.rows - 1;
+    } else if (cell.y >= state.config.rows) {
+        cell.y = 0;
+    }
+    return cell;
+}
+
+StepResult step(GameState& state, Direction input) {
+    if (state.result != RUNNING) {
+        return state.result;
+    }
+
+    if (!isOpposite(input, state.direction)) {
+        state.direction = input;
+    }
+
+    ++state.ticks;
+    state.timeMs += state.config.stepMs;
+
+    SnakeSegment head = nextCell(state, state.snake.head(), state.direction);
+    state.previousHead = state.snake.head();
+
+    if (isWallAt(state, head.x, head.y)) {
+        state.result = HIT_WALL;
+        return state.result;
+    }
+
+    bool ateFood = head.x == state.food.x && head.y == state.food.y;
+    bool ateBonusFood = !ateFood && state.bonusFoodActive &&
+                        head.x == state.bonusFood.x && head.y == state.bonusFood.y;
+
+    if (!ateFood && !ateBonusFood) {
+        popSnakeTail(state);
+    }
+
+    // The tail has already been dropped, so moving into the cell it just left is fine
+    if (isSnakeCell(state, head.x, head.y)) {
+        state.result = HIT_SELF;
+        return state.result;
+    }
+
+    // Occupy the new head cell before spawning so food never lands under it
+    pushSnakeHead(state, head);
+
+    if (ateFood) {
+        state.regularFoodEaten++;
+        state.score += state.config.foodScore;
+
+        // No free cell left means the snake has filled the board; an
+        // endless board always has one
+        if (!spawnFood(state)) {
+            state.result = BOARD_FULL;
+            return state.result;
+        }
+
+        if (state.regularFoodEaten == state.config.foodPerBonus) {
+            state.regularFoodEaten = 0;
+            spawnBonusFood(state);
+        }
+    } else if (ateBonusFood) {
+        state.score += state.config.bonusScore;
+        removeBonusFood(state);
+        if (!spawnFood(state)) {
+            state.result = BOARD_FULL;
+            return state.result;
+        }
+    }
+
+    runTimers(state);
+    return state.result;
+}
@@ -0,0 +1,155 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <cstdint>
+#include <vector>
+#include "snake_body.h"
+#include "run_body.h"
+#include "direction_body.h"
+#include "cell_bitmap.h"
+#include "level.h"
+#include "free_cells.h"
+#include "chunk_world.h"
+#include "timer_queue.h"
+
+// The game rules with no SDL in sight. Everything here works in board
+// cells; front-ends multiply by their tile size when drawing. Nothing in
+// step() renders, sleeps or exits, so games can be run headless as fast
+// as the CPU allows.
+
+// Direction enum declaration
+enum Direction {
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT
+};
+
+// Why step() stopped the game, or RUNNING if it did not
+enum StepResult {
+    RUNNING,
+    HIT_WALL,
+    HIT_SELF,
+    BOARD_FULL
+};
+
+// What a timer in GameState::timers does when it fires
+enum TimerEvent {
+    BONUS_FOOD_EXPIRES
+};
+
+const int MAX_BOARD_SIDE = 4096;           // Largest board in cells either way
+
+struct GameConfig {
+    // Board size, 3 to MAX_BOARD_SIDE cells a side. An endless board has no edges and ignores walls below;
+    // cols x rows is then the area around the head food spawns in.
+    int cols = 64;
+    int rows = 48;
+    bool endless = false;
+    int tileSize = 10;              // Pixel size the wall rectangles are laid out for
+    std::vector<WallRect> walls;
+
+    int stepMs = 100;               // Simulated time per step
+    int foodScore = 10;
+    int bonusScore = 15;
+    int foodPerBonus = 3;           // Regular food eaten before a bonus food appears
+    int bonusDurationMs = 6000;     // Rounded up to whole steps
+};
+
+// Small deterministic generator (splitmix64). Unlike std::rand or the
+// std distributions it gives the same sequence on every platform.
+struct Rng {
+    uint64_t state = 0;
+
+    void seed(uint64_t value) { state = value; }
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound)
+    int below(int bound) {
+        uint32_t range = static_cast<uint32_t>(bound);
+        uint32_t limit = static_cast<uint32_t>(-range) % range;
+        while (true) {
+            uint64_t product = (next() >> 32) * range;
+            if (static_cast<uint32_t>(product) >= limit) {
+                return static_cast<int>(product >> 32);
+            }
+        }
+    }
+};
+
+// The body is a ring of segments unless built with -DSNAKE_RUN_BODY,
+// which stores its straight runs, or -DSNAKE_PACKED_BODY, two bits a
+// segment for running very many games at once
+#if defined(SNAKE_PACKED_BODY)
+typedef DirectionBody GameBody;
+#elif defined(SNAKE_RUN_BODY)
+typedef RunBody GameBody;
+#else
+typedef SnakeBody GameBody;
+#endif
+
+struct GameState {
+    GameConfig config;
+    Level level;
+
+    GameBody snake;
+    CellBitmap snakeCells;          // Kept in sync with snake by the push/pop helpers
+    FreeCellSet freeCells;          // Cells food may spawn on, also kept in sync with snake
+    ChunkWorld world;               // Endless boards keep the snake here instead of the two above
+    SnakeSegment previousHead;      // Head before the last step, for interpolation
+
+    SnakeSegment food, bonusFood;
+    bool bonusFoodActive = false;
+    int bonusFoodTimer = -1;        // Handle of the BONUS_FOOD_EXPIRES timer, -1 when none
+
+    Direction direction = RIGHT;
+    int score = 0;
+    int regularFoodEaten = 0;
+    long long ticks = 0;
+    long long timeMs = 0;           // Simulated time, advances stepMs per step
+
+    // Everything that happens some number of steps from now. Timers count
+    // steps, not wall-clock time, so pausing stops them and headless runs
+    // fast-forward them.
+    TimerQueue timers;
+
+    Rng rng;
+    StepResult result = RUNNING;
+};
+
+// Loads the level and starts a fresh game
+void initGame(GameState& state, const GameConfig& config, uint64_t seed);
+
+// Starts over on the already loaded level
+void resetGame(GameState& state, uint64_t seed);
+
+// Advances one tick. input is the direction the player asked for; a
+// reversal onto the snake's own neck is ignored. Once the result is not
+// RUNNING further calls do nothing.
+StepResult step(GameState& state, Direction input);
+
+bool isOpposite(Direction a, Direction b);
+
+// Moves the food, or places the bonus food and restarts its timer, on a
+// uniformly random free cell. step() calls these; they are public for
+// benchmarks. Both return false when there is no free cell left, which
+// never happens on an endless board.
+bool spawnFood(GameState& state);
+bool spawnBonusFood(GameState& state);
+
+// A duration in milliseconds as a whole number of steps, rounded up
+long long ticksFor(const GameConfig& config, int ms);
+
+// O(1) queries for front-ends and bots, in cell coordinates. Endless
+// boards have their own walls, see chunkWall().
+bool isSnakeCell(const GameState& state, int cx, int cy);
+bool isWallAt(const GameState& state, int cx, int cy);
+SnakeSegment nextCell(const GameState& state, SnakeSegment cell, Direction direction);
+
+#endif
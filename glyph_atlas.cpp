@@ -0,0 +1,145 @@
+#include "glyph_atlas.h"
+
+#include <iostream>
+
+bool createGlyphAtlas(SDL_Renderer* renderer, TTF_Font* font, GlyphAtlas& atlas) {
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* glyphSurfaces[GLYPH_COUNT] = {};
+
+    atlas.lineHeight = TTF_FontHeight(font);
+
+    // Shelf-pack the glyphs left to right, one font height per row
+    int penX = 0;
+    int penY = 0;
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        Uint32 ch = static_cast<Uint32>(FIRST_GLYPH + i);
+        int advance = 0;
+        TTF_GlyphMetrics32(font, ch, nullptr, nullptr, nullptr, nullptr, &advance);
+
+        Glyph& glyph = atlas.glyphs[i];
+        glyph.advance = advance;
+        glyph.src = {0, 0, 0, 0};
+
+        glyphSurfaces[i] = TTF_RenderGlyph32_Blended(font, ch, white);
+        if (!glyphSurfaces[i]) {
+            continue;
+        }
+
+        int w = glyphSurfaces[i]->w;
+        if (penX + w > ATLAS_WIDTH) {
+            penX = 0;
+            penY += atlas.lineHeight;
+        }
+        glyph.src = {penX, penY, w, glyphSurfaces[i]->h};
+        penX += w;
+    }
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, penY + atlas.lineHeight, 32,
+                                                        SDL_PIXELFORMAT_RGBA32);
+    if (!sheet) {
+        std::cerr << "Failed to create glyph atlas surface: " << SDL_GetError() << std::endl;
+        for (SDL_Surface* surface : glyphSurfaces) {
+            SDL_FreeSurface(surface);
+        }
+        return false;
+    }
+
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        if (!glyphSurfaces[i]) {
+            continue;
+        }
+        // Copy coverage and alpha verbatim instead of blending onto the empty sheet
+        SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(glyphSurfaces[i], nullptr, sheet, &atlas.glyphs[i].src);
+        SDL_FreeSurface(glyphSurfaces[i]);
+    }
+
+    atlas.texture = SDL_CreateTextureFromSurface(renderer, sheet);
+    atlas.textureWidth = sheet->w;
+    atlas.textureHeight = sheet->h;
+    SDL_FreeSurface(sheet);
+
+    if (!atlas.texture) {
+        std::cerr << "Failed to create glyph atlas texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void destroyGlyphAtlas(GlyphAtlas& atlas) {
+    if (atlas.texture) {
+        SDL_DestroyTexture(atlas.texture);
+        atlas.texture = nullptr;
+    }
+    atlas.vertices.clear();
+    atlas.indices.clear();
+}
+
+static const Glyph* findGlyph(const GlyphAtlas& atlas, char c) {
+    int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+    if (index < 0 || index >= GLYPH_COUNT) {
+        index = '?' - FIRST_GLYPH;
+    }
+    return &atlas.glyphs[index];
+}
+
+int measureText(const GlyphAtlas& atlas, const std::string& text) {
+    int width = 0;
+    for (char c : text) {
+        width += findGlyph(atlas, c)->advance;
+    }
+    return width;
+}
+
+void queueText(GlyphAtlas& atlas, const std::string& text, int x, int y, SDL_Color color) {
+    if (!atlas.texture) {
+        return;
+    }
+
+    float invW = 1.0f / atlas.textureWidth;
+    float invH = 1.0f / atlas.textureHeight;
+
+    int penX = x;
+    for (char c : text) {
+        const Glyph* glyph = findGlyph(atlas, c);
+        const SDL_Rect& src = glyph->src;
+
+        if (src.w > 0 && src.h > 0) {
+            float left = static_cast<float>(penX);
+            float top = static_cast<float>(y);
+            float right = left + src.w;
+            float bottom = top + src.h;
+            float u0 = src.x * invW;
+            float v0 = src.y * invH;
+            float u1 = (src.x + src.w) * invW;
+            float v1 = (src.y + src.h) * invH;
+
+            int base = static_cast<int>(atlas.vertices.size());
+            atlas.vertices.push_back({{left, top}, color, {u0, v0}});
+            atlas.vertices.push_back({{right, top}, color, {u1, v0}});
+            atlas.vertices.push_back({{right, bottom}, color, {u1, v1}});
+            atlas.vertices.push_back({{left, bottom}, color, {u0, v1}});
+
+            atlas.indices.push_back(base);
+            atlas.indices.push_back(base + 1);
+            atlas.indices.push_back(base + 2);
+            atlas.indices.push_back(base);
+            atlas.indices.push_back(base + 2);
+            atlas.indices.push_back(base + 3);
+        }
+
+        penX += glyph->advance;
+    }
+}
+
+void flushText(SDL_Renderer* renderer, GlyphAtlas& atlas) {
+    if (!atlas.vertices.empty()) {
+        SDL_RenderGeometry(renderer, atlas.texture,
+                           atlas.vertices.data(), static_cast<int>(atlas.vertices.size()),
+                           atlas.indices.data(), static_cast<int>(atlas.indices.size()));
+    }
+    // clear() keeps the capacity, so steady-state frames never reallocate
+    atlas.vertices.clear();
+    atlas.indices.clear();
+}
@@ -0,0 +1,41 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <vector>
+
+// Printable ASCII is all the game ever draws
+const int FIRST_GLYPH = 32;
+const int LAST_GLYPH = 126;
+const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+const int ATLAS_WIDTH = 1024;
+
+struct Glyph {
+    SDL_Rect src;   // Cell inside the atlas texture
+    int advance;    // Pen movement after drawing this glyph
+};
+
+// All glyphs of one font rasterized once into a single texture.
+// Strings are queued as textured quads and submitted with one
+// SDL_RenderGeometry call, so drawing text never creates textures.
+struct GlyphAtlas {
+    SDL_Texture* texture = nullptr;
+    int textureWidth = 0, textureHeight = 0;
+    Glyph glyphs[GLYPH_COUNT];
+    int lineHeight = 0;
+
+    // Reused between frames so queueing text does not allocate
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
+
+bool createGlyphAtlas(SDL_Renderer* renderer, TTF_Font* font, GlyphAtlas& atlas);
+void destroyGlyphAtlas(GlyphAtlas& atlas);
+
+int measureText(const GlyphAtlas& atlas, const std::string& text);
+void queueText(GlyphAtlas& atlas, const std::string& text, int x, int y, SDL_Color color);
+void flushText(SDL_Renderer* renderer, GlyphAtlas& atlas);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include "game.h"
+
+// A turn the player asked for and when the key went down
+struct TimedInput {
+    Direction direction;
+    std::chrono::steady_clock::time_point pressedAt;
+#ifdef SNAKE_LATENCY
+    std::chrono::steady_clock::time_point handledAt;    // When it was queued
+#endif
+};
+
+// Key presses waiting for the simulation, oldest first. One thread pushes
+// (the event loop) and one pops (the simulation, one turn per step), with
+// no locks: each side only writes its own index. Bounded so mashing keys
+// cannot queue up turns that play out long after the player stopped.
+class InputQueue {
+public:
+    static const unsigned CAPACITY = 4;     // Power of two
+
+    // Producer side. Returns false, dropping the input, when full.
+    bool push(const TimedInput& input) {
+        unsigned back = tail.load(std::memory_order_relaxed);
+        if (back - head.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        entries[back % CAPACITY] = input;
+        tail.store(back + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(TimedInput& input) {
+        unsigned front = head.load(std::memory_order_relaxed);
+        if (front == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        input = entries[front % CAPACITY];
+        head.store(front + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; drops everything queued so far
+    void drain() {
+        head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    TimedInput entries[CAPACITY];
+    alignas(64) std::atomic<unsigned> head{0};     // Next to pop, written by the consumer
+    alignas(64) std::atomic<unsigned> tail{0};     // Next to fill, written by the producer
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "latency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+void recordLatency(LatencySamples& samples, float ms) {
+    samples.ms.push_back(ms);
+}
+
+float latencyPercentile(const LatencySamples& samples, double p) {
+    if (samples.ms.empty()) {
+        return 0;
+    }
+    std::vector<float> sorted = samples.ms;
+    size_t rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+    size_t index = rank > 0 ? rank - 1 : 0;
+    index = std::min(index, sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+void printLatencySummary(std::ostream& out, const char* name, const LatencySamples& samples) {
+    out << name << ": " << samples.ms.size() << " samples";
+    if (!samples.ms.empty()) {
+        out << ", p50 " << latencyPercentile(samples, 50) << " ms"
+            << ", p90 " << latencyPercentile(samples, 90) << " ms"
+            << ", p99 " << latencyPercentile(samples, 99) << " ms"
+            << ", max " << latencyPercentile(samples, 100) << " ms";
+    }
+    out << std::endl;
+}
+
+static float millisecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+
+void recordTurnPresented(LatencyReport& report, const TurnTrace& turn,
+                         std::chrono::steady_clock::time_point presentedAt) {
+    recordLatency(report.eventToHandled, millisecondsBetween(turn.pressedAt, turn.handledAt));
+    recordLatency(report.handledToApplied, millisecondsBetween(turn.handledAt, turn.appliedAt));
+    recordLatency(report.appliedToPresented, millisecondsBetween(turn.appliedAt, presentedAt));
+    recordLatency(report.total, millisecondsBetween(turn.pressedAt, presentedAt));
+}
+
+const int HISTOGRAM_BUCKETS = 250;     // 1 ms each; the last one also takes everything slower
+
+static void writeStage(std::ostream& out, const char* name, const LatencySamples& samples) {
+    out << "stage " << name << " samples " << samples.ms.size()
+        << " p50 " << latencyPercentile(samples, 50)
+        << " p95 " << latencyPercentile(samples, 95)
+        << " p99 " << latencyPercentile(samples, 99)
+        << " max " << latencyPercentile(samples, 100) << "\n";
+
+    std::vector<int> buckets(HISTOGRAM_BUCKETS, 0);
+    for (float ms : samples.ms) {
+        int bucket = ms > 0 ? static_cast<int>(ms) : 0;
+        ++buckets[std::min(bucket, HISTOGRAM_BUCKETS - 1)];
+    }
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        if (buckets[bucket] > 0) {
+            out << "  " << bucket << " ms " << buckets[bucket] << "\n";
+        }
+    }
+}
+
+bool saveLatencyReport(const LatencyReport& report, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "# Key press to presented frame, in milliseconds; histogram lines are <bucket start> ms <count>\n";
+    writeStage(out, "event_to_handled", report.eventToHandled);
+    writeStage(out, "handled_to_applied", report.handledToApplied);
+    writeStage(out, "applied_to_presented", report.appliedToPresented);
+    writeStage(out, "total", report.total);
+    return static_cast<bool>(out);
+}
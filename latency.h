@@ -0,0 +1,47 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Latency samples in milliseconds, kept whole so any percentile can be
+// read off at the end. A sample per key press is a few KB an hour.
+struct LatencySamples {
+    std::vector<float> ms;
+};
+
+void recordLatency(LatencySamples& samples, float ms);
+
+// Nearest-rank percentile, p in 0..100; 0 when there are no samples
+float latencyPercentile(const LatencySamples& samples, double p);
+
+// One line: count, p50, p90, p99 and max
+void printLatencySummary(std::ostream& out, const char* name, const LatencySamples& samples);
+
+// End-to-end tracing, compiled into the game only with -DSNAKE_LATENCY.
+// A turn is timed at each hand-off on its way to the screen: the key
+// event (by SDL's own timestamp), handleInput() queueing it, the step
+// that applied it, and the first SDL_RenderPresent() showing the turned
+// head. All times are on steady_clock.
+struct TurnTrace {
+    std::chrono::steady_clock::time_point pressedAt;
+    std::chrono::steady_clock::time_point handledAt;
+    std::chrono::steady_clock::time_point appliedAt;
+};
+
+struct LatencyReport {
+    LatencySamples eventToHandled;      // Waiting in SDL's event queue
+    LatencySamples handledToApplied;    // Waiting for the next step
+    LatencySamples appliedToPresented;  // Waiting for a frame to show it
+    LatencySamples total;
+};
+
+void recordTurnPresented(LatencyReport& report, const TurnTrace& turn,
+                         std::chrono::steady_clock::time_point presentedAt);
+
+// Writes p50/p95/p99 and a 1 ms histogram of every stage as text
+bool saveLatencyReport(const LatencyReport& report, const std::string& path);
+
+#endif
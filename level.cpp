@@ -0,0 +1,34 @@
+#include "level.h"
+
+#include <algorithm>
+
+// Obstacle rectangles, rasterized into the game's wall grid at startup
+const std::vector<WallRect> levelWalls = {
+    {220, 70, 200, 15},
+    {220, 380, 200, 15},
+    {95, 130, 15, 200},
+    {530, 150, 15, 200},
+};
+
+void loadLevel(Level& level, const std::vector<WallRect>& walls, int cols, int rows, int tileSize) {
+    level.walls = walls;
+    level.tileSize = tileSize;
+    level.wallCells.reset(cols, rows);
+
+    // Mark every cell a rectangle overlaps, matching the old per-tick AABB test
+    for (const WallRect& wall : walls) {
+        if (wall.w <= 0 || wall.h <= 0 || wall.x + wall.w <= 0 || wall.y + wall.h <= 0) {
+            continue;
+        }
+        int firstCol = std::max(wall.x / tileSize, 0);
+        int firstRow = std::max(wall.y / tileSize, 0);
+        int lastCol = std::min((wall.x + wall.w - 1) / tileSize, cols - 1);
+        int lastRow = std::min((wall.y + wall.h - 1) / tileSize, rows - 1);
+
+        for (int cy = firstRow; cy <= lastRow; ++cy) {
+            for (int cx = firstCol; cx <= lastCol; ++cx) {
+                level.wallCells.set(cx, cy);
+            }
+        }
+    }
+}
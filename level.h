@@ -0,0 +1,39 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <vector>
+#include "cell_bitmap.h"
+
+// Obstacle rectangle in pixel coordinates, laid out like SDL_Rect
+struct WallRect {
+    int x, y, w, h;
+};
+
+// Static level geometry. The rectangles are kept for drawing; collision
+// only ever looks at wallCells, which loadLevel() fills once, so a wall
+// test costs the same no matter how many obstacles the level has.
+struct Level {
+    std::vector<WallRect> walls;
+    CellBitmap wallCells;
+    int tileSize = 1;
+};
+
+// The game's own level, shared by the window, runner and benchmarks: a
+// 640x480 screen of 10 pixel tiles with four walls across it
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int TILE_SIZE = 10;
+const int GRID_COLS = SCREEN_WIDTH / TILE_SIZE;
+const int GRID_ROWS = SCREEN_HEIGHT / TILE_SIZE;
+const int MOVEMENT_DELAY = 100;            // Milliseconds between steps
+const int BONUS_FOOD_DURATION = 6000;      // Milliseconds a bonus food stays up
+extern const std::vector<WallRect> levelWalls;
+
+void loadLevel(Level& level, const std::vector<WallRect>& walls, int cols, int rows, int tileSize);
+
+// Cell coordinates; anything outside the grid is not a wall
+inline bool isWallCell(const Level& level, int cx, int cy) {
+    return level.wallCells.inBounds(cx, cy) && level.wallCells.test(cx, cy);
+}
+
+#endif
@@ -0,0 +1,365 @@
+#include "lockstep.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Lanes per cache block: run() steps one block for all requested ticks
+// before moving on, so its rings and bitmaps stay in L1/L2
+const int LANE_BLOCK = 64;
+const int LANE_ALIGN = 8;
+
+LockstepGames::LockstepGames(const GameConfig& config, int laneCount, uint64_t seed)
+    : cols(config.cols), rows(config.rows), cells(config.cols * config.rows),
+      wordsPerLane((config.cols * config.rows + 31) / 32), foodScore(config.foodScore) {
+    assert(cells <= 65536 && cols < 32768 && rows < 32768 && !config.endless);
+
+    this->laneCount = (std::max(laneCount, 1) + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN;
+    int n = this->laneCount;
+
+    Level level;
+    loadLevel(level, config.walls, cols, rows, config.tileSize);
+    wallWords.assign((cells + 31) / 32, 0);
+    for (int cy = 0; cy < rows; ++cy) {
+        for (int cx = 0; cx < cols; ++cx) {
+            if (isWallCell(level, cx, cy)) {
+                int cell = cy * cols + cx;
+                wallWords[cell >> 5] |= uint32_t(1) << (cell & 31);
+            }
+        }
+    }
+
+    laneHeadX.assign(n, 0);
+    laneHeadY.assign(n, 0);
+    laneDir.assign(n, RIGHT);
+    laneFoodX.assign(n, 0);
+    laneFoodY.assign(n, 0);
+    laneLength.assign(n, 0);
+    laneScore.assign(n, 0);
+    laneTicks.assign(n, 0);
+    laneRingHead.assign(n, 0);
+    laneRng.assign(n, Rng());
+    nextCellIndex.assign(n, 0);
+    tailCellIndex.assign(n, 0);
+    laneEvent.assign(n, 0);
+    rings.assign(static_cast<size_t>(n) * cells + 1, 0);
+    occupancy.assign(static_cast<size_t>(n) * wordsPerLane, 0);
+
+    for (int lane = 0; lane < n; ++lane) {
+        laneRng[lane].seed(seed + lane);
+        resetLane(lane);
+    }
+}
+
+void LockstepGames::resetLane(int lane) {
+    uint32_t* words = &occupancy[static_cast<size_t>(lane) * wordsPerLane];
+    std::fill(words, words + wordsPerLane, 0);
+
+    int x = cols / 2;
+    int y = rows / 2;
+    int cell = y * cols + x;
+    rings[static_cast<size_t>(lane) * cells] = static_cast<uint16_t>(cell);
+    words[cell >> 5] |= uint32_t(1) << (cell & 31);
+
+    laneRingHead[lane] = 0;
+    laneLength[lane] = 1;
+    laneHeadX[lane] = x;
+    laneHeadY[lane] = y;
+    laneDir[lane] = RIGHT;
+    laneScore[lane] = 0;
+    laneTicks[lane] = 0;
+    placeFood(lane);
+}
+
+// Interior cells that are neither wall nor snake, like spawnFood() in game.cpp
+bool LockstepGames::placeFood(int lane) {
+    Rng& rng = laneRng[lane];
+    auto usable = [this, lane](int cx, int cy) {
+        int cell = cy * cols + cx;
+        bool wall = (wallWords[cell >> 5] >> (cell & 31)) & 1;
+        return !wall && !occupied(lane, cell);
+    };
+
+    for (int attempt = 0; attempt < 32; ++attempt) {
+        int cx = 1 + rng.below(cols - 2);
+        int cy = 1 + rng.below(rows - 2);
+        if (usable(cx, cy)) {
+            laneFoodX[lane] = cx;
+            laneFoodY[lane] = cy;
+            return true;
+        }
+    }
+
+    // Nearly full board: take the first usable cell after a random start
+    int start = rng.below(cells);
+    for (int i = 0; i < cells; ++i) {
+        int cell = (start + i) % cells;
+        int cx = cell % cols;
+        int cy = cell / cols;
+        if (cx > 0 && cy > 0 && cx < cols - 1 && cy < rows - 1 && usable(cx, cy)) {
+            laneFoodX[lane] = cx;
+            laneFoodY[lane] = cy;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LockstepGames::finishLane(int lane, StepResult result) {
+    ++finishedGames;
+    finishedScoreSum += laneScore[lane];
+    ++endingCounts[result];
+    resetLane(lane);
+}
+
+
+// Tail lookup and self-collision test for one lane whose move has been
+// computed, then the ring head and length for after the tick. A lane
+// moving into the cell its tail is leaving this tick is not a collision.
+void LockstepGames::bodyKernel(int lane) {
+    int cell = nextCellIndex[lane];
+    int event = laneEvent[lane];
+    if ((wallWords[cell >> 5] >> (cell & 31)) & 1) {
+        event |= EVENT_WALL;
+    }
+
+    int head = laneRingHead[lane];
+    int length = laneLength[lane];
+    int tailSlot = head + length - 1;
+    if (tailSlot >= cells) {
+        tailSlot -= cells;
+    }
+    int tail = rings[static_cast<size_t>(lane) * cells + tailSlot];
+    bool ate = event & EVENT_FOOD;
+    if (occupied(lane, cell) && (ate || cell != tail)) {
+        event |= EVENT_SELF;
+    }
+
+    tailCellIndex[lane] = tail;
+    laneEvent[lane] = event;
+    laneRingHead[lane] = (head == 0 ? cells : head) - 1;
+    laneLength[lane] = length + ate;
+    ++laneTicks[lane];
+}
+
+// Chase policy, move, wrap, wall, food and body tests for lanes
+// [firstLane, lastLane). Directions are UP=0, DOWN=1, LEFT=2, RIGHT=3, so
+// a reversal is (a ^ b) == 1.
+void LockstepGames::moveKernel(int firstLane, int lastLane) {
+    int lane = firstLane;
+
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i four = _mm256_set1_epi32(4);
+    const __m256i lowBits = _mm256_set1_epi32(31);
+    const __m256i lowHalf = _mm256_set1_epi32(0xFFFF);
+    const __m256i colCount = _mm256_set1_epi32(cols);
+    const __m256i cellCount = _mm256_set1_epi32(cells);
+    const __m256i laneWords = _mm256_set1_epi32(wordsPerLane);
+    const __m256i lastCol = _mm256_set1_epi32(cols - 1);
+    const __m256i lastRow = _mm256_set1_epi32(rows - 1);
+    const __m256i lastCell = _mm256_set1_epi32(cells - 1);
+    const __m256i laneStep = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    // Gather indices are relative to the block so they stay well inside int range
+    const int* walls = reinterpret_cast<const int*>(wallWords.data());
+    const int* blockRings = reinterpret_cast<const int*>(&rings[static_cast<size_t>(firstLane) * cells]);
+    const int* blockWords = reinterpret_cast<const int*>(&occupancy[static_cast<size_t>(firstLane) * wordsPerLane]);
+
+    for (; lane + 8 <= lastLane; lane += 8) {
+        __m256i hx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneHeadX[lane]));
+        __m256i hy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneHeadY[lane]));
+        __m256i dir = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneDir[lane]));
+        __m256i fx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneFoodX[lane]));
+        __m256i fy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneFoodY[lane]));
+
+        // Later blends win: horizontal moves take priority over vertical ones
+        __m256i want = dir;
+        want = _mm256_blendv_epi8(want, zero, _mm256_cmpgt_epi32(hy, fy));
+        want = _mm256_blendv_epi8(want, one, _mm256_cmpgt_epi32(fy, hy));
+        want = _mm256_blendv_epi8(want, two, _mm256_cmpgt_epi32(hx, fx));
+        want = _mm256_blendv_epi8(want, three, _mm256_cmpgt_epi32(fx, hx));
+        __m256i reversal = _mm256_cmpeq_epi32(_mm256_xor_si256(want, dir), one);
+        dir = _mm256_blendv_epi8(want, dir, reversal);
+
+        // cmpeq yields -1 for true, so these are -1/0/+1 steps
+        __m256i stepX = _mm256_sub_epi32(_mm256_cmpeq_epi32(dir, two), _mm256_cmpeq_epi32(dir, three));
+        __m256i stepY = _mm256_sub_epi32(_mm256_cmpeq_epi32(dir, zero), _mm256_cmpeq_epi32(dir, one));
+        __m256i nx = _mm256_add_epi32(hx, stepX);
+        __m256i ny = _mm256_add_epi32(hy, stepY);
+
+        nx = _mm256_blendv_epi8(nx, lastCol, _mm256_cmpgt_epi32(zero, nx));
+        nx = _mm256_blendv_epi8(nx, zero, _mm256_cmpgt_epi32(nx, lastCol));
+        ny = _mm256_blendv_epi8(ny, lastRow, _mm256_cmpgt_epi32(zero, ny));
+        ny = _mm256_blendv_epi8(ny, zero, _mm256_cmpgt_epi32(ny, lastRow));
+
+        __m256i cell = _mm256_add_epi32(_mm256_mullo_epi32(ny, colCount), nx);
+        __m256i bit = _mm256_and_si256(cell, lowBits);
+        __m256i wallWord = _mm256_i32gather_epi32(walls, _mm256_srli_epi32(cell, 5), 4);
+        __m256i wall = _mm256_and_si256(_mm256_srlv_epi32(wallWord, bit), one);
+        __m256i ate = _mm256_and_si256(_mm256_cmpeq_epi32(nx, fx), _mm256_cmpeq_epi32(ny, fy));
+
+        // Tail cell: 32-bit gather of the 16-bit ring slot, low half kept
+        __m256i blockLane = _mm256_add_epi32(_mm256_set1_epi32(lane - firstLane), laneStep);
+        __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneRingHead[lane]));
+        __m256i length = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneLength[lane]));
+        __m256i tailSlot = _mm256_sub_epi32(_mm256_add_epi32(head, length), one);
+        tailSlot = _mm256_sub_epi32(tailSlot, _mm256_and_si256(_mm256_cmpgt_epi32(tailSlot, lastCell), cellCount));
+        __m256i ringIndex = _mm256_add_epi32(_mm256_mullo_epi32(blockLane, cellCount), tailSlot);
+        __m256i tail = _mm256_and_si256(_mm256_i32gather_epi32(blockRings, ringIndex, 2), lowHalf);
+
+        __m256i wordIndex = _mm256_add_epi32(_mm256_mullo_epi32(blockLane, laneWords), _mm256_srli_epi32(cell, 5));
+        __m256i bodyWord = _mm256_i32gather_epi32(blockWords, wordIndex, 4);
+        __m256i body = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srlv_epi32(bodyWord, bit), one), one);
+        __m256i vacated = _mm256_andnot_si256(ate, _mm256_cmpeq_epi32(cell, tail));
+        __m256i self = _mm256_andnot_si256(vacated, body);
+
+        __m256i event = _mm256_or_si256(wall, _mm256_or_si256(_mm256_and_si256(self, two), _mm256_and_si256(ate, four)));
+        __m256i nextHead = _mm256_sub_epi32(head, one);
+        nextHead = _mm256_blendv_epi8(nextHead, lastCell, _mm256_cmpgt_epi32(zero, nextHead));
+        __m256i ticks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&laneTicks[lane]));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneHeadX[lane]), nx);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneHeadY[lane]), ny);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneDir[lane]), dir);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&nextCellIndex[lane]), cell);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&tailCellIndex[lane]), tail);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneEvent[lane]), event);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneRingHead[lane]), nextHead);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneLength[lane]), _mm256_sub_epi32(length, ate));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&laneTicks[lane]), _mm256_add_epi32(ticks, one));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i three = _mm_set1_epi32(3);
+    const __m128i four = _mm_set1_epi32(4);
+    const __m128i colCount = _mm_set1_epi32(cols);
+    const __m128i lastCol = _mm_set1_epi32(cols - 1);
+    const __m128i lastRow = _mm_set1_epi32(rows - 1);
+
+    // SSE2 has no blendv: pick a where mask is set, b elsewhere
+    auto select = [](__m128i mask, __m128i a, __m128i b) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    };
+
+    for (; lane + 4 <= lastLane; lane += 4) {
+        __m128i hx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&laneHeadX[lane]));
+        __m128i hy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&laneHeadY[lane]));
+        __m128i dir = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&laneDir[lane]));
+        __m128i fx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&laneFoodX[lane]));
+        __m128i fy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&laneFoodY[lane]));
+
+        __m128i want = dir;
+        want = select(_mm_cmpgt_epi32(hy, fy), zero, want);
+        want = select(_mm_cmpgt_epi32(fy, hy), one, want);
+        want = select(_mm_cmpgt_epi32(hx, fx), two, want);
+        want = select(_mm_cmpgt_epi32(fx, hx), three, want);
+        __m128i reversal = _mm_cmpeq_epi32(_mm_xor_si128(want, dir), one);
+        dir = select(reversal, dir, want);
+
+        __m128i stepX = _mm_sub_epi32(_mm_cmpeq_epi32(dir, two), _mm_cmpeq_epi32(dir, three));
+        __m128i stepY = _mm_sub_epi32(_mm_cmpeq_epi32(dir, zero), _mm_cmpeq_epi32(dir, one));
+        __m128i nx = _mm_add_epi32(hx, stepX);
+        __m128i ny = _mm_add_epi32(hy, stepY);
+
+        nx = select(_mm_cmpgt_epi32(zero, nx), lastCol, nx);
+        nx = select(_mm_cmpgt_epi32(nx, lastCol), zero, nx);
+        ny = select(_mm_cmpgt_epi32(zero, ny), lastRow, ny);
+        ny = select(_mm_cmpgt_epi32(ny, lastRow), zero, ny);
+
+        // No 32-bit mullo in SSE2; both factors fit in 15 bits, so one
+        // 16-bit multiply-add per lane gives the exact product
+        __m128i cell = _mm_add_epi32(_mm_madd_epi16(ny, colCount), nx);
+        __m128i ate = _mm_and_si128(_mm_cmpeq_epi32(nx, fx), _mm_cmpeq_epi32(ny, fy));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&laneHeadX[lane]), nx);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&laneHeadY[lane]), ny);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&laneDir[lane]), dir);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&nextCellIndex[lane]), cell);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&laneEvent[lane]), _mm_and_si128(ate, four));
+
+        // Nor gathers: the wall and body lookups stay scalar
+        for (int i = lane; i < lane + 4; ++i) {
+            bodyKernel(i);
+        }
+    }
+#endif
+
+    // Scalar version of the same kernel, for leftovers and non-x86 builds
+    for (; lane < lastLane; ++lane) {
+        int hx = laneHeadX[lane];
+        int hy = laneHeadY[lane];
+        int dir = laneDir[lane];
+        int fx = laneFoodX[lane];
+        int fy = laneFoodY[lane];
+
+        int want = fx > hx ? RIGHT : fx < hx ? LEFT : fy > hy ? DOWN : fy < hy ? UP : dir;
+        if ((want ^ dir) != 1) {
+            dir = want;
+        }
+
+        int nx = hx + (dir == RIGHT) - (dir == LEFT);
+        int ny = hy + (dir == DOWN) - (dir == UP);
+        nx = nx < 0 ? cols - 1 : nx >= cols ? 0 : nx;
+        ny = ny < 0 ? rows - 1 : ny >= rows ? 0 : ny;
+
+        laneHeadX[lane] = nx;
+        laneHeadY[lane] = ny;
+        laneDir[lane] = dir;
+        nextCellIndex[lane] = ny * cols + nx;
+        laneEvent[lane] = nx == fx && ny == fy ? EVENT_FOOD : 0;
+        bodyKernel(lane);
+    }
+}
+
+void LockstepGames::tickBlock(int firstLane, int lastLane) {
+    moveKernel(firstLane, lastLane);
+    totalTicks += lastLane - firstLane;
+
+    // What the kernels cannot do: the stores, and the rare lanes that ate or died.
+    // laneRingHead already points at the new head's slot.
+    for (int lane = firstLane; lane < lastLane; ++lane) {
+        int event = laneEvent[lane];
+        if (event & EVENT_WALL) {
+            finishLane(lane, HIT_WALL);
+            continue;
+        }
+        if (event & EVENT_SELF) {
+            finishLane(lane, HIT_SELF);
+            continue;
+        }
+
+        uint32_t* words = &occupancy[static_cast<size_t>(lane) * wordsPerLane];
+        int cell = nextCellIndex[lane];
+        if (!(event & EVENT_FOOD)) {
+            int tail = tailCellIndex[lane];
+            words[tail >> 5] &= ~(uint32_t(1) << (tail & 31));
+        }
+        words[cell >> 5] |= uint32_t(1) << (cell & 31);
+        rings[static_cast<size_t>(lane) * cells + laneRingHead[lane]] = static_cast<uint16_t>(cell);
+
+        if (event & EVENT_FOOD) {
+            laneScore[lane] += foodScore;
+            if (!placeFood(lane)) {
+                finishLane(lane, BOARD_FULL);
+            }
+        }
+    }
+}
+
+void LockstepGames::run(int ticks) {
+    for (int first = 0; first < laneCount; first += LANE_BLOCK) {
+        int last = std::min(first + LANE_BLOCK, laneCount);
+        for (int t = 0; t < ticks; ++t) {
+            tickBlock(first, last);
+        }
+    }
+}
@@ -5,73 +5,132 @@
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+#include "frame_renderer.h"
+#include "glyph_atlas.h"
+#include "text_cache.h"
+#include "game.h"
+#include "latency.h"
+#include "profiler.h"
+#include "replay.h"
+#include "sim_thread.h"
 
 #undef main
 
-// Direction enum declaration
-enum Direction {
-    UP,
-    DOWN,
-    LEFT,
-    RIGHT
-};
-
 // Constants
-const int SCREEN_WIDTH = 640;
-const int SCREEN_HEIGHT = 480;
-const int TILE_SIZE = 10;
-const int REGULAR_FOOD_SIZE = TILE_SIZE;
-const int BONUS_FOOD_SIZE = TILE_SIZE; // Double the size
 const int TARGET_FRAME_RATE = 60;          // Frames per second
-const int MOVEMENT_DELAY = 100;            // Milliseconds delay between movements
-const int BONUS_FOOD_DURATION = 6000;      // 4 seconds
-
-// Snake structure
-struct SnakeSegment {
-    int x, y;
-};
+const int GAME_OVER_DELAY = 3000;          // How long the game over screen stays up
+const int IDLE_WAIT_MS = 500;              // Longest a menu sleeps before checking again
+const char* const REPLAY_FILE = "last.replay";  // Every game played is recorded here
+const int TEXT_CACHE_CAPACITY = 32;        // Distinct strings kept as textures with --text-cache
+#ifdef SNAKE_LATENCY
+const char* const LATENCY_FILE = "latency.txt"; // Written at exit in latency builds
+#endif
+#ifdef SNAKE_PROFILE
+const char* const TRACE_FILE = "trace.json";    // Written at exit and on PROFILE_KEY in profiling builds
+const SDL_Keycode PROFILE_KEY = SDLK_F9;
+#endif
 
 // Function prototypes
-void spawnFood();
-void spawnBonusFood();
-void eatBonusFood();
-void update();
-void render();
-void handleInput();
-void handleBonusFoodDuration();
+void render(const GameSnapshot& view, float alpha);
+void handleInput(const SDL_KeyboardEvent& key);
 void displayGameOver();
+void drawGameOverScreen();
 bool showWelcomeScreen();
-
-// Obstacle rectangles
-SDL_Rect wallRect1{220, 70, 200, 15};
-SDL_Rect wallRect2{220, 380, 200, 15};
-SDL_Rect wallRect3{95, 130, 15, 200};
-SDL_Rect wallRect4{530, 150, 15, 200};
-
+void drawWelcomeScreen();
+bool isRedrawEvent(const SDL_Event& e);
+void saveProfile();
 
 // Global variables
 SDL_Window* window;
 SDL_Renderer* renderer;
-std::vector<SnakeSegment> snake;
-SnakeSegment food, bonusFood;
-Direction snakeDirection = Direction::RIGHT; // Initialize the direction
-int score = 0;
-int regularFoodEaten = 0;
-Uint32 bonusFoodTimer = 0;
-bool bonusFoodActive = false;
+GameState game;                               // All rules and state live in game.cpp
 bool gamePaused = false;
 
-// TTF Font and Textures
+// Steps game on its own thread while it runs; everything drawn in the
+// meantime comes from its snapshots. The level and config are only read
+// here, which is safe since nothing changes them after initGame().
+SimThread simulation;
+
+#ifdef SNAKE_LATENCY
+// Every turn from key event to the first frame presented with it
+LatencyReport latencyReport;
+long long presentedTurns = 0;
+#endif
+
+// Recording of the game being played, or the replay being watched
+Replay replay;
+ReplayCursor replayCursor;
+bool replaying = false;
+
+// TTF Font and the glyph atlas all text is drawn from, or with --text-cache
+// a cache of whole-string textures instead
 TTF_Font* font;
-SDL_Texture* scoreTexture;
-SDL_Texture* levelTexture;
-SDL_Texture* welcomeTexture;
+GlyphAtlas textAtlas;
+bool useTextCache = false;
+TextCache textCache;
+
+// Draws the game screen and all text, see frame_renderer.h. A board that
+// is not exactly the window (--board), or one with no edges at all
+// (--endless), is drawn through its camera.
+FrameRenderer frame;
+
+// With --menu-idle the welcome screen gives up waiting for a click after
+// this long, so idle_cpu_bench can time it; 0 waits for ever
+Uint32 menuIdleExitMs = 0;
+
+// --game-over-idle holds the game over screen for this long instead, so
+// idle_cpu_bench can time the screen apart from the game before it
+Uint32 gameOverDelayMs = GAME_OVER_DELAY;
 
 // Button Rectangles
 SDL_Rect yesButton = {150, 350, 100, 50};
 SDL_Rect noButton = {400, 350, 100, 50};
 
+// main [--replay file [--speed factor]] [--board COLSxROWS] [--endless] [--incremental] [--text-cache]
+//      [--menu-idle seconds] [--game-over-idle seconds]
+//
+// With --endless, --board sets the area around the head food appears in
 int main(int argc, char* args[]) {
+    std::string replayPath;
+    double replaySpeed = 1.0;
+    int boardCols = GRID_COLS;
+    int boardRows = GRID_ROWS;
+    bool endless = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = args[i];
+        if (arg == "--replay" && i + 1 < argc) {
+            replayPath = args[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            replaySpeed = std::atof(args[++i]);
+        } else if (arg == "--board" && i + 1 < argc) {
+            if (std::sscanf(args[++i], "%dx%d", &boardCols, &boardRows) != 2 || boardCols < 3 || boardRows < 3 ||
+                boardCols > MAX_BOARD_SIDE || boardRows > MAX_BOARD_SIDE) {
+                std::cerr << "--board takes COLSxROWS, each 3 to " << MAX_BOARD_SIDE << std::endl;
+                return 1;
+            }
+        } else if (arg == "--endless") {
+            endless = true;
+        } else if (arg == "--incremental") {
+            frame.incremental = true;
+        } else if (arg == "--text-cache") {
+            useTextCache = true;
+        } else if (arg == "--menu-idle" && i + 1 < argc) {
+            menuIdleExitMs = std::max(static_cast<Uint32>(std::atof(args[++i]) * 1000), Uint32(1));
+        } else if (arg == "--game-over-idle" && i + 1 < argc) {
+            gameOverDelayMs = std::max(static_cast<Uint32>(std::atof(args[++i]) * 1000), Uint32(1));
+        }
+    }
+    if (!replayPath.empty()) {
+        if (!loadReplay(replay, replayPath) || replaySpeed <= 0) {
+            std::cerr << "Cannot play replay " << replayPath << std::endl;
+            return 1;
+        }
+        replaying = true;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
         return 1;
@@ -85,13 +144,25 @@ int main(int argc, char* args[]) {
 
     window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
                               SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-
-    std::srand(static_cast<unsigned>(std::time(0)));
-
-    snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-
-    spawnFood();
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+
+    // Present already paces frames when vsync took effect; otherwise cap at TARGET_FRAME_RATE
+    SDL_RendererInfo rendererInfo;
+    bool vsyncEnabled = SDL_GetRendererInfo(renderer, &rendererInfo) == 0 &&
+                        (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    GameConfig config;
+    config.cols = boardCols;
+    config.rows = boardRows;
+    config.endless = endless;
+    config.tileSize = TILE_SIZE;
+    config.walls = levelWalls;
+    config.stepMs = MOVEMENT_DELAY;
+    config.bonusDurationMs = BONUS_FOOD_DURATION;
+    if (replaying) {
+        config = replay.config;
+    }
+    initGame(game, config, static_cast<uint64_t>(std::time(0)));
 
     // Load font
     font = TTF_OpenFont("Moonlight.otf", 40); // Replace "arial.ttf" with the path to your font file
@@ -105,10 +176,36 @@ int main(int argc, char* args[]) {
         return 1;
     }
 
-// Show welcome screen
-    bool startGame = showWelcomeScreen();
+    // Rasterize every glyph once; text drawing after this never creates textures
+    if (!createGlyphAtlas(renderer, font, textAtlas)) {
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        TTF_CloseFont(font);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    initTextCache(textCache, font, TEXT_CACHE_CAPACITY);
+
+    initFrameRenderer(frame, renderer, SCREEN_WIDTH, SCREEN_HEIGHT, TILE_SIZE, &textAtlas);
+    frame.textCache = useTextCache ? &textCache : nullptr;
+    frame.followCamera = config.endless || config.cols != GRID_COLS || config.rows != GRID_ROWS;
+    if (frame.incremental && frame.followCamera) {
+        std::cerr << "Incremental rendering needs the board to fit the window, drawing full frames" << std::endl;
+        frame.incremental = false;
+    }
+    if (frame.incremental && !createScene(frame)) {
+        std::cerr << "Incremental rendering unavailable, drawing full frames" << std::endl;
+        frame.incremental = false;
+    }
+
+// Show welcome screen; a replay starts straight away
+    bool startGame = replaying || showWelcomeScreen();
 
     if (!startGame) {
+        destroyFrameRenderer(frame);
+        clearTextCache(textCache);
+        destroyGlyphAtlas(textAtlas);
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         TTF_CloseFont(font);
@@ -117,59 +214,112 @@ int main(int argc, char* args[]) {
         return 0;
     }
 
-     snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-
-    spawnFood();
+    if (replaying) {
+        resetGame(game, replay.seed);
+        startPlayback(replayCursor, replay);
+    } else {
+        uint64_t seed = static_cast<uint64_t>(std::time(0));
+        resetGame(game, seed);
+        beginReplay(replay, game.config, seed);
+    }
 
-    // Main game loop
+    // Main game loop: the simulation thread advances in fixed MOVEMENT_DELAY
+    // steps while this thread handles events and renders its newest
+    // snapshot as often as vsync or TARGET_FRAME_RATE allow
     bool quit = false;
     SDL_Event e;
 
+    const std::chrono::nanoseconds stepDuration(
+        static_cast<long long>(game.config.stepMs * 1000000.0 / replaySpeed));
+    const Uint64 frameTicks = SDL_GetPerformanceFrequency() / TARGET_FRAME_RATE;
+    // Only the incremental renderer reads the snapshots' occupancy bitmap
+    simulation.start(game, replay, replaying ? &replayCursor : nullptr, stepDuration, frame.incremental);
+    PROFILE_THREAD("main");
+
     while (!quit) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                quit = true;
-            } else if (e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_p) {
-                    gamePaused = !gamePaused;
-                }
-            }else if (e.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-
-                if (mouseX >= yesButton.x && mouseX <= yesButton.x + yesButton.w &&
-                    mouseY >= yesButton.y && mouseY <= yesButton.y + yesButton.h) {
-                    startGame = true;
-                    snake.clear();
-                    snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-                    spawnFood();
-                    score = 0;
-                    regularFoodEaten = 0;
-                    bonusFoodActive = false;
-                    bonusFoodTimer = 0;
-                    gamePaused = false;
-                } else if (mouseX >= noButton.x && mouseX <= noButton.x + noButton.w &&
-                           mouseY >= noButton.y && mouseY <= noButton.y + noButton.h) {
-                    startGame = false;
+        PROFILE_ZONE("frame");
+
+        // Nothing moves while paused, so sleep until an event arrives
+        // instead of redrawing the same frame TARGET_FRAME_RATE times a second
+        if (gamePaused) {
+            PROFILE_ZONE("paused wait");
+            SDL_WaitEventTimeout(nullptr, IDLE_WAIT_MS);
+        }
+
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+
+        {
+            PROFILE_ZONE("poll events");
+            while (SDL_PollEvent(&e) != 0) {
+                if (e.type == SDL_QUIT) {
                     quit = true;
+                } else if ((e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) ||
+                           e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+                    // Target textures can lose their contents with the device or the window size
+                    invalidateBackground(frame);
+                    if (e.type == SDL_RENDER_DEVICE_RESET) {
+                        // The old textures are gone altogether
+                        clearTextCache(textCache);
+                        if (frame.incremental) {
+                            frame.incremental = createScene(frame);
+                        }
+                    }
+                } else if (e.type == SDL_KEYDOWN) {
+                    if (e.key.keysym.sym == SDLK_p) {
+                        gamePaused = !gamePaused;
+                        simulation.setPaused(gamePaused);
+#ifdef SNAKE_PROFILE
+                    } else if (e.key.keysym.sym == PROFILE_KEY) {
+                        saveProfile();
+#endif
+                    } else {
+                        handleInput(e.key);
+                    }
+                }else if (e.type == SDL_MOUSEBUTTONDOWN) {
+                    int mouseX, mouseY;
+                    SDL_GetMouseState(&mouseX, &mouseY);
+
+                    // Restarting is for players; a replay runs to its end
+                    if (!replaying && mouseX >= yesButton.x && mouseX <= yesButton.x + yesButton.w &&
+                        mouseY >= yesButton.y && mouseY <= yesButton.y + yesButton.h) {
+                        simulation.restart(static_cast<uint64_t>(std::time(0)));
+                        gamePaused = false;
+                        simulation.setPaused(false);
+                    } else if (mouseX >= noButton.x && mouseX <= noButton.x + noButton.w &&
+                               mouseY >= noButton.y && mouseY <= noButton.y + noButton.h) {
+                        startGame = false;
+                        quit = true;
+                    }
                 }
             }
-
-            handleInput();
         }
 
-        if (!gamePaused && startGame) {
-            update();
+        // The game ended, or the replay being watched ran out
+        if (simulation.finished()) {
+            break;
         }
 
-        render();
+        // Draw the newest step, with the head eased in by the time since it ran
+        simulation.refresh();
+        const GameSnapshot& view = simulation.latest();
+        float alpha = 1.0f;
+        if (!gamePaused) {
+            alpha = std::chrono::duration<float>(std::chrono::steady_clock::now() - view.steppedAt) / stepDuration;
+            alpha = alpha < 1.0f ? alpha : 1.0f;
+        }
+        render(view, alpha);
 
-        SDL_Delay(MOVEMENT_DELAY);
+        if (!vsyncEnabled) {
+            waitForFrameDeadline(frameStart + frameTicks);
+        }
     }
 
     // Cleanup and exit
     displayGameOver();
 
+    destroyFrameRenderer(frame);
+    clearTextCache(textCache);
+    destroyGlyphAtlas(textAtlas);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_CloseFont(font);
@@ -178,7 +328,52 @@ int main(int argc, char* args[]) {
     return 0;
 }
 
+// Blocks on the event queue until the player picks Yes or No. The screen is
+// static, so it is drawn once and only redrawn when the window needs it.
 bool showWelcomeScreen() {
+    drawWelcomeScreen();
+
+    // Nothing is animating on the menu, so let the display sleep
+    SDL_EnableScreenSaver();
+
+    Uint32 idleDeadline = SDL_GetTicks() + menuIdleExitMs;
+    SDL_Event e;
+    while (true) {
+        if (!SDL_WaitEventTimeout(&e, IDLE_WAIT_MS)) {
+            if (menuIdleExitMs != 0 && SDL_TICKS_PASSED(SDL_GetTicks(), idleDeadline)) {
+                return false;
+            }
+            continue;
+        }
+
+        if (e.type == SDL_QUIT) {
+            return false;
+        } else if (isRedrawEvent(e)) {
+            drawWelcomeScreen();
+        } else if (e.type == SDL_MOUSEBUTTONDOWN) {
+            int mouseX, mouseY;
+            SDL_GetMouseState(&mouseX, &mouseY);
+
+            if (mouseX >= yesButton.x && mouseX <= yesButton.x + yesButton.w &&
+                mouseY >= yesButton.y && mouseY <= yesButton.y + yesButton.h) {
+                SDL_DisableScreenSaver();
+                return true;
+            } else if (mouseX >= noButton.x && mouseX <= noButton.x + noButton.w &&
+                       mouseY >= noButton.y && mouseY <= noButton.y + noButton.h) {
+                return false;
+            }
+        }
+    }
+}
+
+// Window events after which the previously presented frame may be gone
+bool isRedrawEvent(const SDL_Event& e) {
+    return e.type == SDL_WINDOWEVENT &&
+           (e.window.event == SDL_WINDOWEVENT_EXPOSED || e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+            e.window.event == SDL_WINDOWEVENT_RESTORED);
+}
+
+void drawWelcomeScreen() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
@@ -186,14 +381,10 @@ bool showWelcomeScreen() {
     std::string welcomeText = " GAME START?";
 
     // Render welcome message
-    SDL_Surface* welcomeSurface = TTF_RenderText_Solid(font, welcomeText.c_str(), textColor);
-    welcomeTexture = SDL_CreateTextureFromSurface(renderer, welcomeSurface);
-
-    SDL_Rect welcomeRect = {(SCREEN_WIDTH - welcomeSurface->w) / 2, (SCREEN_HEIGHT - welcomeSurface->h) / 2,
-                             welcomeSurface->w, welcomeSurface->h};
-    SDL_RenderCopy(renderer, welcomeTexture, nullptr, &welcomeRect);
-
-    SDL_FreeSurface(welcomeSurface);
+    int welcomeWidth = measureString(frame, welcomeText, textColor);
+    queueString(frame, welcomeText, (SCREEN_WIDTH - welcomeWidth) / 2, (SCREEN_HEIGHT - textAtlas.lineHeight) / 2,
+                textColor);
+    flushStrings(frame);
 
     // Render buttons
     SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
@@ -204,262 +395,116 @@ bool showWelcomeScreen() {
 
     // Render button text
     std::string yesButtonText = "Yes";
-    SDL_Surface* yesButtonSurface = TTF_RenderText_Solid(font, yesButtonText.c_str(), textColor);
-    SDL_Texture* yesButtonTexture = SDL_CreateTextureFromSurface(renderer, yesButtonSurface);
-
-    SDL_Rect yesButtonRect = {yesButton.x + (yesButton.w - yesButtonSurface->w) / 2,
-                              yesButton.y + (yesButton.h - yesButtonSurface->h) / 2,
-                              yesButtonSurface->w, yesButtonSurface->h};
-    SDL_RenderCopy(renderer, yesButtonTexture, nullptr, &yesButtonRect);
-
-    SDL_FreeSurface(yesButtonSurface);
+    queueString(frame, yesButtonText, yesButton.x + (yesButton.w - measureString(frame, yesButtonText, textColor)) / 2,
+                yesButton.y + (yesButton.h - textAtlas.lineHeight) / 2, textColor);
 
-std::string noButtonText = "No";
-    SDL_Surface* noButtonSurface = TTF_RenderText_Solid(font, noButtonText.c_str(), textColor);
-        SDL_Texture* noButtonTexture = SDL_CreateTextureFromSurface(renderer, noButtonSurface);
+    std::string noButtonText = "No";
+    queueString(frame, noButtonText, noButton.x + (noButton.w - measureString(frame, noButtonText, textColor)) / 2,
+                noButton.y + (noButton.h - textAtlas.lineHeight) / 2, textColor);
 
-    SDL_Rect noButtonRect = {noButton.x + (noButton.w - noButtonSurface->w) / 2,
-                             noButton.y + (noButton.h - noButtonSurface->h) / 2,
-                             noButtonSurface->w, noButtonSurface->h};
-    SDL_RenderCopy(renderer, noButtonTexture, nullptr, &noButtonRect);
-
-    SDL_FreeSurface(noButtonSurface);
+    flushStrings(frame);
 
     SDL_RenderPresent(renderer);
-
-    // Wait for user input
-    SDL_Event e;
-    while (true) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                return false;
-            } else if (e.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-
-                if (mouseX >= yesButton.x && mouseX <= yesButton.x + yesButton.w &&
-                    mouseY >= yesButton.y && mouseY <= yesButton.y + yesButton.h) {
-                    return true;
-                } else if (mouseX >= noButton.x && mouseX <= noButton.x + noButton.w &&
-                           mouseY >= noButton.y && mouseY <= noButton.y + noButton.h) {
-                    return false;
-                }
-            }
-        }
-    }
-}
-
-void spawnFood() {
-    int maxX = (SCREEN_WIDTH - 2 * TILE_SIZE) / TILE_SIZE;
-    int maxY = (SCREEN_HEIGHT - 2 * TILE_SIZE) / TILE_SIZE;
-
-    food.x = TILE_SIZE + rand() % maxX * TILE_SIZE;
-    food.y = TILE_SIZE + rand() % maxY * TILE_SIZE;
-
-    if ((food.x + TILE_SIZE > wallRect1.x && food.x < wallRect1.x + wallRect1.w &&
-     food.y + TILE_SIZE > wallRect1.y && food.y < wallRect1.y + wallRect1.h) ||
-    (food.x + TILE_SIZE > wallRect2.x && food.x < wallRect2.x + wallRect2.w &&
-     food.y + TILE_SIZE > wallRect2.y && food.y < wallRect2.y + wallRect2.h) ||
-    (food.x + TILE_SIZE > wallRect3.x && food.x < wallRect3.x + wallRect3.w &&
-     food.y + TILE_SIZE > wallRect3.y && food.y < wallRect3.y + wallRect3.h) ||
-    (food.x + TILE_SIZE > wallRect4.x && food.x < wallRect4.x + wallRect4.w &&
-     food.y + TILE_SIZE > wallRect4.y && food.y < wallRect4.y + wallRect4.h)) {
-    spawnFood();
-    return;
-}
-
 }
 
-void spawnBonusFood() {
-    int maxX = (SCREEN_WIDTH - 2 * TILE_SIZE) / TILE_SIZE;
-    int maxY = (SCREEN_HEIGHT - 2 * TILE_SIZE) / TILE_SIZE;
-
-    bonusFood.x = TILE_SIZE + rand() % maxX * TILE_SIZE;
-    bonusFood.y = TILE_SIZE + rand() % maxY * TILE_SIZE;
-
-    if ((bonusFood.x + TILE_SIZE > wallRect1.x && bonusFood.x < wallRect1.x + wallRect1.w &&
-     bonusFood.y + TILE_SIZE > wallRect1.y && bonusFood.y < wallRect1.y + wallRect1.h) ||
-    (bonusFood.x + TILE_SIZE > wallRect2.x && bonusFood.x < wallRect2.x + wallRect2.w &&
-     bonusFood.y + TILE_SIZE > wallRect2.y && bonusFood.y < wallRect2.y + wallRect2.h) ||
-    (bonusFood.x + TILE_SIZE > wallRect3.x && bonusFood.x < wallRect3.x + wallRect3.w &&
-     bonusFood.y + TILE_SIZE > wallRect3.y && bonusFood.y < wallRect3.y + wallRect3.h) ||
-    (bonusFood.x + TILE_SIZE > wallRect4.x && bonusFood.x < wallRect4.x + wallRect4.w &&
-     bonusFood.y + TILE_SIZE > wallRect4.y && bonusFood.y < wallRect4.y + wallRect4.h) ) {
-    spawnBonusFood();
-    return;
-}
-
-    bonusFoodActive = true;
-    bonusFoodTimer = SDL_GetTicks();
-}
-
-void eatBonusFood() {
-    bonusFoodActive = false;
-    // Add any other logic you may need after eating the bonus food
+// Draws one snapshot from the simulation thread; alpha is how far (0..1)
+// the simulation is between that step and the next
+void render(const GameSnapshot& view, float alpha) {
+    renderFrame(frame, game, view, alpha);
+
+#ifdef SNAKE_LATENCY
+    // A turn whose snapshot was overwritten before any frame drew it (two
+    // turns within one frame) is not counted
+    if (view.turnsApplied != presentedTurns) {
+        presentedTurns = view.turnsApplied;
+        recordTurnPresented(latencyReport, view.lastTurn, std::chrono::steady_clock::now());
+    }
+#endif
 }
 
-void update() {
-    SnakeSegment head = snake.front();
-    switch (snakeDirection) {
-        case Direction::UP:
-            head.y -= TILE_SIZE;
+// Every arrow key press goes to the simulation's input queue, which turns
+// the snake one press per step. Auto-repeat adds nothing a held key has not
+// already asked for. The press is dated by the event's own timestamp, so
+// time spent waiting in SDL's queue during a slow frame counts as latency.
+void handleInput(const SDL_KeyboardEvent& key) {
+    PROFILE_ZONE("handle input");
+    Direction direction;
+    switch (key.keysym.scancode) {
+        case SDL_SCANCODE_UP:
+            direction = Direction::UP;
             break;
-        case Direction::DOWN:
-            head.y += TILE_SIZE;
+        case SDL_SCANCODE_DOWN:
+            direction = Direction::DOWN;
             break;
-        case Direction::LEFT:
-            head.x -= TILE_SIZE;
+        case SDL_SCANCODE_LEFT:
+            direction = Direction::LEFT;
             break;
-        case Direction::RIGHT:
-            head.x += TILE_SIZE;
+        case SDL_SCANCODE_RIGHT:
+            direction = Direction::RIGHT;
             break;
+        default:
+            return;
     }
-
-    /*if (head.x < TILE_SIZE || head.x >= SCREEN_WIDTH - TILE_SIZE ||
-        head.y < TILE_SIZE || head.y >= SCREEN_HEIGHT - TILE_SIZE) {
-        displayGameOver();
+    if (key.repeat) {
         return;
-    }*/
-
-    // Wrap around the screen if the head hits the boundary
-    if (head.x < 0) {
-        head.x = SCREEN_WIDTH - TILE_SIZE;
-    } else if (head.x >= SCREEN_WIDTH) {
-        head.x = 0;
-    }
-
-    if (head.y < 0) {
-        head.y = SCREEN_HEIGHT - TILE_SIZE;
-    } else if (head.y >= SCREEN_HEIGHT) {
-        head.y = 0;
     }
 
-    if ((head.x + TILE_SIZE > wallRect1.x && head.x < wallRect1.x + wallRect1.w &&
-         head.y + TILE_SIZE > wallRect1.y && head.y < wallRect1.y + wallRect1.h) ||
-        (head.x + TILE_SIZE > wallRect2.x && head.x < wallRect2.x + wallRect2.w &&
-         head.y + TILE_SIZE > wallRect2.y && head.y < wallRect2.y + wallRect2.h) ||
-        (head.x + TILE_SIZE > wallRect3.x && head.x < wallRect3.x + wallRect3.w &&
-         head.y + TILE_SIZE > wallRect3.y && head.y < wallRect3.y + wallRect3.h) ||
-        (head.x + TILE_SIZE > wallRect4.x && head.x < wallRect4.x + wallRect4.w &&
-         head.y + TILE_SIZE > wallRect4.y && head.y < wallRect4.y + wallRect4.h)) {
-        displayGameOver();
-        return;
-    }
+    Uint32 waited = SDL_GetTicks() - key.timestamp;
+    simulation.queueInput(direction, std::chrono::steady_clock::now() - std::chrono::milliseconds(waited));
+}
 
-    if (head.x == food.x && head.y == food.y) {
-        regularFoodEaten++;
-
-        if (regularFoodEaten == 3) {
-            regularFoodEaten = 0;
-            score += 10;
-            spawnFood();
-            spawnBonusFood();
-        } else {
-            score += 10;
-            spawnFood();
+void displayGameOver() {
+    // The game and its replay are this thread's again once the simulation has stopped
+    simulation.stop();
+    saveProfile();
+    if (!replaying) {
+        printLatencySummary(std::cout, "Key press to turn", simulation.inputLatency());
+#ifdef SNAKE_LATENCY
+        printLatencySummary(std::cout, "Key press to screen", latencyReport.total);
+        if (!saveLatencyReport(latencyReport, LATENCY_FILE)) {
+            std::cerr << "Failed to save " << LATENCY_FILE << std::endl;
         }
-    } else if (bonusFoodActive && head.x == bonusFood.x && head.y == bonusFood.y) {
-        score += 15;
-        bonusFoodActive = false;
-        spawnFood();
-    } else {
-        snake.pop_back();
+#endif
     }
 
-    for (const auto& segment : snake) {
-        if (head.x == segment.x && head.y == segment.y) {
-            displayGameOver();
-            return;
+    if (!replaying) {
+        finishReplay(replay, game);
+        if (!saveReplay(replay, REPLAY_FILE)) {
+            std::cerr << "Failed to save " << REPLAY_FILE << std::endl;
         }
     }
 
-    snake.insert(snake.begin(), head);
-
-    handleBonusFoodDuration();
-}
-
-void render() {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    SDL_SetRenderDrawColor(renderer, 0, 128, 128, 0);
-    SDL_Rect topWall = {0, 0, SCREEN_WIDTH, TILE_SIZE};
-    SDL_Rect bottomWall = {0, SCREEN_HEIGHT - TILE_SIZE, SCREEN_WIDTH, TILE_SIZE};
-    SDL_Rect leftWall = {0, 0, TILE_SIZE, SCREEN_HEIGHT};
-    SDL_Rect rightWall = {SCREEN_WIDTH - TILE_SIZE, 0, TILE_SIZE, SCREEN_HEIGHT};
-    SDL_RenderFillRect(renderer, &topWall);
-    SDL_RenderFillRect(renderer, &bottomWall);
-    SDL_RenderFillRect(renderer, &leftWall);
-    SDL_RenderFillRect(renderer, &rightWall);
-
-    SDL_SetRenderDrawColor(renderer, 128, 0, 128, 255);
-    SDL_RenderFillRect(renderer, &wallRect1);
-    SDL_RenderFillRect(renderer, &wallRect2);
-    SDL_RenderFillRect(renderer, &wallRect3);
-    SDL_RenderFillRect(renderer, &wallRect4);
-    SDL_SetRenderDrawColor(renderer, 85, 107, 47, 255);
-    for (const auto& segment : snake) {
-        SDL_Rect rect = {segment.x, segment.y, TILE_SIZE, TILE_SIZE};
-        SDL_RenderFillRect(renderer, &rect);
-    }
-
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_Rect foodRect = {food.x, food.y, REGULAR_FOOD_SIZE, REGULAR_FOOD_SIZE};
-    SDL_RenderFillRect(renderer, &foodRect);
-
-    if (bonusFoodActive) {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-        SDL_Rect bonusFoodRect = {bonusFood.x, bonusFood.y, BONUS_FOOD_SIZE, BONUS_FOOD_SIZE};
-        SDL_RenderFillRect(renderer, &bonusFoodRect);
-    }
-
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string scoreText = "Score: " + std::to_string(score);
-
-    // Render score
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(font, scoreText.c_str(), textColor);
-    scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-
-    SDL_Rect scoreRect = {10, 10, scoreSurface->w, scoreSurface->h};
-    SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
+    drawGameOverScreen();
+    SDL_EnableScreenSaver();
 
-    SDL_FreeSurface(scoreSurface);
-
-    // Render level board (you can customize it based on your game's logic)
-    std::string levelText = "Level: 1"; // Customize based on your game's logic
-    SDL_Surface* levelSurface = TTF_RenderText_Solid(font, levelText.c_str(), textColor);
-    levelTexture = SDL_CreateTextureFromSurface(renderer, levelSurface);
-
-    SDL_Rect levelRect = {SCREEN_WIDTH - levelSurface->w - 10, 10, levelSurface->w, levelSurface->h};
-    SDL_RenderCopy(renderer, levelTexture, nullptr, &levelRect);
-
-    SDL_FreeSurface(levelSurface);
-
-    SDL_RenderPresent(renderer);
-}
-
-void handleInput() {
-    const Uint8* currentKeyStates = SDL_GetKeyboardState(nullptr);
-
-    if (currentKeyStates[SDL_SCANCODE_UP] && snakeDirection != Direction::DOWN) {
-        snakeDirection = Direction::UP;
-    } else if (currentKeyStates[SDL_SCANCODE_DOWN] && snakeDirection != Direction::UP) {
-        snakeDirection = Direction::DOWN;
-    } else if (currentKeyStates[SDL_SCANCODE_LEFT] && snakeDirection != Direction::RIGHT) {
-        snakeDirection = Direction::LEFT;
-    } else if (currentKeyStates[SDL_SCANCODE_RIGHT] && snakeDirection != Direction::LEFT) {
-        snakeDirection = Direction::RIGHT;
+    // Keep the message up for a few seconds, asleep on the event queue so
+    // closing the window still works and a covered window gets redrawn
+    Uint32 deadline = SDL_GetTicks() + gameOverDelayMs;
+    SDL_Event e;
+    bool quit = false;
+    while (!quit && !SDL_TICKS_PASSED(SDL_GetTicks(), deadline)) {
+        int remaining = static_cast<int>(deadline - SDL_GetTicks());
+        if (SDL_WaitEventTimeout(&e, remaining > 0 ? remaining : 1)) {
+            if (e.type == SDL_QUIT) {
+                quit = true;
+            } else if (isRedrawEvent(e)) {
+                drawGameOverScreen();
+            }
+        }
     }
-}
 
-void handleBonusFoodDuration() {
-    if (bonusFoodActive && (SDL_GetTicks() - bonusFoodTimer >= BONUS_FOOD_DURATION)) {
-        bonusFoodActive = false;
-        spawnFood();
-    }
+    destroyFrameRenderer(frame);
+    clearTextCache(textCache);
+    destroyGlyphAtlas(textAtlas);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    TTF_CloseFont(font);
+    TTF_Quit();
+    SDL_Quit();
+    exit(0);
 }
 
-void displayGameOver() {
+void drawGameOverScreen() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
@@ -467,37 +512,29 @@ void displayGameOver() {
     std::string gameOverText = "Game Over!!";
 
     // Render "Game Over" message with score
-    SDL_Surface* gameOverSurface = TTF_RenderText_Solid(font, gameOverText.c_str(), textColor);
-    SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-
-    SDL_Rect gameOverRect = {(SCREEN_WIDTH - gameOverSurface->w) / 2, (SCREEN_HEIGHT - gameOverSurface->h) / 2,
-                             gameOverSurface->w, gameOverSurface->h};
-    SDL_RenderCopy(renderer, gameOverTexture, nullptr, &gameOverRect);
+    int gameOverWidth = measureString(frame, gameOverText, textColor);
+    queueString(frame, gameOverText, (SCREEN_WIDTH - gameOverWidth) / 2, (SCREEN_HEIGHT - textAtlas.lineHeight) / 2,
+                textColor);
 
-    std::string scoreText = "Score: " + std::to_string(score);
+    std::string scoreText = "Score: " + std::to_string(game.score);
 
     // Render score
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(font, scoreText.c_str(), textColor);
-    scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
+    queueString(frame, scoreText, (SCREEN_WIDTH - gameOverWidth) / 2, SCREEN_HEIGHT / 2 + textAtlas.lineHeight,
+                textColor);
 
-    SDL_Rect scoreRect = {(SCREEN_WIDTH - gameOverSurface->w)/2, (SCREEN_HEIGHT/2 + gameOverSurface->h),
-                             gameOverSurface->w, gameOverSurface->h};
-    SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
-
-    SDL_FreeSurface(scoreSurface);
-
-    SDL_FreeSurface(gameOverSurface);
-    SDL_DestroyTexture(gameOverTexture);
+    flushStrings(frame);
 
     SDL_RenderPresent(renderer);
+}
 
-    // Wait for a few seconds before exiting
-    SDL_Delay(3000);
-
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    TTF_CloseFont(font);
-    TTF_Quit();
-    SDL_Quit();
-    exit(0);
-}
\ No newline at end of file
+// Writes every thread's recent profiling zones for chrome://tracing; does
+// nothing unless built with SNAKE_PROFILE
+void saveProfile() {
+#ifdef SNAKE_PROFILE
+    if (writeChromeTrace(TRACE_FILE)) {
+        std::cout << "Wrote " << TRACE_FILE << std::endl;
+    } else {
+        std::cerr << "Failed to save " << TRACE_FILE << std::endl;
+    }
+#endif
+}
@@ -0,0 +1,80 @@
+// Plays replay files back headless at full speed and checks that each one
+// reproduces the recorded game: same number of steps, same score, same
+// ending. --repeat plays every file that many times, which turns a real
+// session into a profiling workload. Exits non-zero if any file fails.
+//
+//   playback [--repeat N] file...
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+#include "game.h"
+#include "replay.h"
+
+static const char* resultName(StepResult result) {
+    switch (result) {
+        case HIT_WALL:
+            return "hit wall";
+        case HIT_SELF:
+            return "hit self";
+        case BOARD_FULL:
+            return "board full";
+        default:
+            return "running";
+    }
+}
+
+int main(int argc, char* args[]) {
+    int repeat = 1;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = args[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::atoi(args[++i]);
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() || repeat <= 0) {
+        std::cerr << "usage: playback [--repeat N] file..." << std::endl;
+        return 2;
+    }
+
+    int failures = 0;
+    GameState game;
+    for (const std::string& path : paths) {
+        Replay replay;
+        if (!loadReplay(replay, path)) {
+            std::cout << path << ": cannot read" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        bool matched = true;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; ++i) {
+            matched = playReplay(game, replay) && matched;
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << path << ": " << (matched ? "ok" : "MISMATCH")
+                  << ", " << replay.ticks << " ticks, score " << replay.finalScore
+                  << ", " << resultName(replay.finalResult)
+                  << ", " << replay.inputs.size() << " input bytes";
+        if (!matched) {
+            std::cout << " (replayed " << game.ticks << " ticks, score " << game.score
+                      << ", " << resultName(game.result) << ")";
+        }
+        if (seconds > 0) {
+            std::cout << ", " << static_cast<double>(game.ticks) * repeat / seconds << " ticks/sec";
+        }
+        std::cout << std::endl;
+
+        if (!matched) {
+            ++failures;
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
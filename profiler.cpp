@@ -0,0 +1,148 @@
+#include "profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// One zone. The fields are atomics only so a trace can be written while
+// the owning thread keeps recording; every access is relaxed and the
+// ring's count orders them.
+struct ProfileSlot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+};
+
+struct ProfileRing {
+    ProfileSlot slots[PROFILE_RING_SIZE];
+    std::atomic<uint64_t> written{0};           // Zones ever recorded; slot is written % size
+    std::atomic<const char*> threadName{nullptr};
+    int threadId = 0;
+};
+
+// Rings are created once per thread and kept until exit, so a trace can
+// still include threads that have finished
+static std::mutex ringsMutex;
+static std::vector<std::unique_ptr<ProfileRing>> rings;
+static thread_local ProfileRing* threadRing = nullptr;
+
+static const std::chrono::steady_clock::time_point profileEpoch = std::chrono::steady_clock::now();
+
+static ProfileRing& currentRing() {
+    if (!threadRing) {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.emplace_back(new ProfileRing);
+        threadRing = rings.back().get();
+        threadRing->threadId = static_cast<int>(rings.size());
+    }
+    return *threadRing;
+}
+
+uint64_t profileNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profileEpoch)
+        .count();
+}
+
+void recordZone(const char* name, uint64_t startNs, uint64_t endNs) {
+    ProfileRing& ring = currentRing();
+    uint64_t index = ring.written.load(std::memory_order_relaxed);
+    // Orders the count of the previous zone before this one's slot writes,
+    // so a reader that sees these writes also sees that count (a seqlock)
+    std::atomic_thread_fence(std::memory_order_release);
+    ProfileSlot& slot = ring.slots[index % PROFILE_RING_SIZE];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.end.store(endNs, std::memory_order_relaxed);
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+void setProfileThreadName(const char* name) {
+    currentRing().threadName.store(name, std::memory_order_relaxed);
+}
+
+struct CopiedZone {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Copies the zones a ring still holds. Slots the owner overwrote while
+// they were being copied are dropped, using the count read afterwards:
+// with that count at n, zone n may be half written over zone n - size.
+static void copyRing(const ProfileRing& ring, std::vector<CopiedZone>& zones) {
+    uint64_t last = ring.written.load(std::memory_order_acquire);
+    uint64_t first = last > PROFILE_RING_SIZE ? last - PROFILE_RING_SIZE : 0;
+
+    std::vector<CopiedZone> copied;
+    copied.reserve(last - first);
+    for (uint64_t i = first; i < last; ++i) {
+        const ProfileSlot& slot = ring.slots[i % PROFILE_RING_SIZE];
+        copied.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                          slot.end.load(std::memory_order_relaxed)});
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = ring.written.load(std::memory_order_relaxed);
+    uint64_t overwritten = after + 1 > PROFILE_RING_SIZE ? after + 1 - PROFILE_RING_SIZE : 0;
+    size_t skip = overwritten > first ? static_cast<size_t>(overwritten - first) : 0;
+    if (skip < copied.size()) {
+        zones.insert(zones.end(), copied.begin() + skip, copied.end());
+    }
+}
+
+// Zone names are literals from our own source, but escape them anyway
+static void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text ? text : "?"; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+bool writeChromeTrace(const std::string& path) {
+    std::vector<ProfileRing*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const std::unique_ptr<ProfileRing>& ring : rings) {
+            snapshot.push_back(ring.get());
+        }
+    }
+
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    std::vector<CopiedZone> zones;
+    for (const ProfileRing* ring : snapshot) {
+        const char* threadName = ring->threadName.load(std::memory_order_relaxed);
+        if (threadName) {
+            out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << ring->threadId << ",\"args\":{\"name\":";
+            writeJsonString(out, threadName);
+            out << "}}";
+            first = false;
+        }
+
+        zones.clear();
+        copyRing(*ring, zones);
+        for (const CopiedZone& zone : zones) {
+            // Complete events, in microseconds
+            out << (first ? "" : ",\n") << "{\"name\":";
+            writeJsonString(out, zone.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId << ",\"ts\":" << zone.start / 1000.0
+                << ",\"dur\":" << (zone.end - zone.start) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,55 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timing zones for seeing where frame time goes. Each thread
+// records into its own fixed ring of the most recent zones, so recording
+// takes no lock and never allocates after the thread's first zone; when
+// the ring is full the oldest zones are overwritten. writeChromeTrace()
+// may be called from any thread at any time and writes what the rings
+// hold as Chrome trace-event JSON (chrome://tracing or ui.perfetto.dev).
+//
+// Zones are compiled in only with -DSNAKE_PROFILE; otherwise PROFILE_ZONE
+// and PROFILE_THREAD expand to nothing.
+
+const int PROFILE_RING_SIZE = 1 << 16;     // Zones kept per thread
+
+// Nanoseconds since program start, on steady_clock
+uint64_t profileNow();
+
+// Adds one finished zone to the calling thread's ring. name must outlive
+// the trace, which in practice means a string literal.
+void recordZone(const char* name, uint64_t startNs, uint64_t endNs);
+
+// Label for the calling thread in the trace
+void setProfileThreadName(const char* name);
+
+bool writeChromeTrace(const std::string& path);
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name(name), start(profileNow()) {}
+    ~ProfileZone() { recordZone(name, start, profileNow()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#ifdef SNAKE_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) setProfileThreadName(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_THREAD(name)
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+#include "rect_batch.h"
+
+int addRectLayer(RectBatch& batch, SDL_Color color) {
+    batch.layers.push_back({color, {}});
+    return static_cast<int>(batch.layers.size()) - 1;
+}
+
+void flushRects(SDL_Renderer* renderer, RectBatch& batch) {
+    for (RectLayer& layer : batch.layers) {
+        if (layer.rects.empty()) {
+            continue;
+        }
+        SDL_SetRenderDrawColor(renderer, layer.color.r, layer.color.g, layer.color.b, layer.color.a);
+        SDL_RenderFillRects(renderer, layer.rects.data(), static_cast<int>(layer.rects.size()));
+        layer.rects.clear();
+    }
+}
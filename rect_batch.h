@@ -0,0 +1,30 @@
+#ifndef RECT_BATCH_H
+#define RECT_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Filled rectangles collected per color and submitted with one
+// SDL_RenderFillRects call per color, instead of a color change and a
+// draw call for every rectangle. Layers are drawn in the order they were
+// added, so later layers paint over earlier ones.
+struct RectLayer {
+    SDL_Color color;
+    std::vector<SDL_Rect> rects;    // Emptied by flushRects but keeps its capacity
+};
+
+struct RectBatch {
+    std::vector<RectLayer> layers;
+};
+
+// Returns the index to queue rectangles of this color under
+int addRectLayer(RectBatch& batch, SDL_Color color);
+
+inline void queueRect(RectBatch& batch, int layer, const SDL_Rect& rect) {
+    batch.layers[layer].rects.push_back(rect);
+}
+
+// Draws every queued rectangle, layer by layer, and empties the layers
+void flushRects(SDL_Renderer* renderer, RectBatch& batch);
+
+#endif
@@ -0,0 +1,224 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iterator>
+
+static const char REPLAY_MAGIC[4] = {'S', 'N', 'K', 'R'};
+static const uint8_t REPLAY_VERSION = 2;     // 2 added the endless flag after the config's numbers
+
+static void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool readVarint(const std::vector<uint8_t>& in, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < in.size(); shift += 7) {
+        uint8_t byte = in[offset++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Wall rectangles may in principle sit off the left or top edge
+static uint64_t zigzag(int value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+static int unzigzag(uint64_t value) {
+    return static_cast<int>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+}
+
+// Zigzag values within half the int range either way, so a wall's x + w
+// cannot overflow when the level is rasterized
+static bool isWallValue(uint64_t value) {
+    return value <= static_cast<uint64_t>(INT_MAX);
+}
+
+void beginReplay(Replay& replay, const GameConfig& config, uint64_t seed) {
+    replay.config = config;
+    replay.seed = seed;
+    replay.inputs.clear();
+    replay.ticks = 0;
+    replay.finalScore = 0;
+    replay.finalResult = RUNNING;
+
+    // A fresh game is already heading right, so that needs no entry
+    replay.lastInput = RIGHT;
+    replay.lastChangeTick = 0;
+}
+
+void recordInput(Replay& replay, Direction input) {
+    if (input != replay.lastInput) {
+        uint64_t delta = static_cast<uint64_t>(replay.ticks - replay.lastChangeTick);
+        writeVarint(replay.inputs, (delta << 2) | static_cast<uint64_t>(input));
+        replay.lastInput = input;
+        replay.lastChangeTick = replay.ticks;
+    }
+    ++replay.ticks;
+}
+
+void finishReplay(Replay& replay, const GameState& state) {
+    replay.ticks = state.ticks;
+    replay.finalScore = state.score;
+    replay.finalResult = state.result;
+}
+
+bool saveReplay(const Replay& replay, const std::string& path) {
+    const GameConfig& config = replay.config;
+    std::vector<uint8_t> out(REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    out.push_back(REPLAY_VERSION);
+
+    writeVarint(out, config.cols);
+    writeVarint(out, config.rows);
+    writeVarint(out, config.tileSize);
+    writeVarint(out, config.stepMs);
+    writeVarint(out, config.foodScore);
+    writeVarint(out, config.bonusScore);
+    writeVarint(out, config.foodPerBonus);
+    writeVarint(out, config.bonusDurationMs);
+    writeVarint(out, config.endless);
+    writeVarint(out, config.walls.size());
+    for (const WallRect& wall : config.walls) {
+        writeVarint(out, zigzag(wall.x));
+        writeVarint(out, zigzag(wall.y));
+        writeVarint(out, zigzag(wall.w));
+        writeVarint(out, zigzag(wall.h));
+    }
+
+    writeVarint(out, replay.seed);
+    writeVarint(out, replay.ticks);
+    writeVarint(out, replay.finalScore);
+    writeVarint(out, replay.finalResult);
+    writeVarint(out, replay.inputs.size());
+    out.insert(out.end(), replay.inputs.begin(), replay.inputs.end());
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return static_cast<bool>(file);
+}
+
+bool loadReplay(Replay& replay, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (in.size() < 5 || !std::equal(REPLAY_MAGIC, REPLAY_MAGIC + 4, in.begin()) || in[4] < 1 ||
+        in[4] > REPLAY_VERSION) {
+        return false;
+    }
+
+    // Version 1 files have no endless flag; read it as 0
+    size_t offset = 5;
+    uint64_t values[10] = {};
+    for (int i = 0; i < 10; ++i) {
+        if (i == 8 && in[4] < 2) {
+            continue;
+        }
+        if (!readVarint(in, offset, values[i])) {
+            return false;
+        }
+    }
+
+    // Every number but the wall count is an int, and none may be negative
+    for (int i = 0; i < 8; ++i) {
+        if (values[i] > static_cast<uint64_t>(INT_MAX)) {
+            return false;
+        }
+    }
+
+    GameConfig config;
+    config.cols = static_cast<int>(values[0]);
+    config.rows = static_cast<int>(values[1]);
+    config.tileSize = static_cast<int>(values[2]);
+    config.stepMs = static_cast<int>(values[3]);
+    config.foodScore = static_cast<int>(values[4]);
+    config.bonusScore = static_cast<int>(values[5]);
+    config.foodPerBonus = static_cast<int>(values[6]);
+    config.bonusDurationMs = static_cast<int>(values[7]);
+    config.endless = values[8] != 0;
+    if (config.cols < 3 || config.rows < 3 || config.cols > MAX_BOARD_SIDE || config.rows > MAX_BOARD_SIDE ||
+        config.tileSize <= 0 || config.stepMs <= 0 || values[9] > in.size()) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < values[9]; ++i) {
+        uint64_t x, y, w, h;
+        if (!readVarint(in, offset, x) || !readVarint(in, offset, y) ||
+            !readVarint(in, offset, w) || !readVarint(in, offset, h) ||
+            !isWallValue(x) || !isWallValue(y) || !isWallValue(w) || !isWallValue(h)) {
+            return false;
+        }
+        config.walls.push_back({unzigzag(x), unzigzag(y), unzigzag(w), unzigzag(h)});
+    }
+
+    uint64_t seed, ticks, score, result, inputBytes;
+    if (!readVarint(in, offset, seed) || !readVarint(in, offset, ticks) || !readVarint(in, offset, score) ||
+        !readVarint(in, offset, result) || !readVarint(in, offset, inputBytes) ||
+        ticks > static_cast<uint64_t>(LLONG_MAX) || score > static_cast<uint64_t>(INT_MAX) ||
+        result > BOARD_FULL || inputBytes != in.size() - offset) {
+        return false;
+    }
+
+    beginReplay(replay, config, seed);
+    replay.inputs.assign(in.begin() + offset, in.end());
+    replay.ticks = static_cast<long long>(ticks);
+    replay.finalScore = static_cast<int>(score);
+    replay.finalResult = static_cast<StepResult>(result);
+    return true;
+}
+
+// Decodes the next change, if any, into nextChangeTick and nextInput
+static void readNextChange(ReplayCursor& cursor) {
+    uint64_t value;
+    if (!readVarint(cursor.replay->inputs, cursor.offset, value)) {
+        cursor.nextChangeTick = -1;
+        return;
+    }
+    cursor.nextChangeTick += static_cast<long long>(value >> 2);
+    cursor.nextInput = static_cast<Direction>(value & 3);
+}
+
+void startPlayback(ReplayCursor& cursor, const Replay& replay) {
+    cursor.replay = &replay;
+    cursor.offset = 0;
+    cursor.tick = 0;
+    cursor.nextChangeTick = 0;
+    cursor.input = RIGHT;
+    readNextChange(cursor);
+}
+
+bool nextReplayInput(ReplayCursor& cursor, Direction& input) {
+    if (cursor.tick >= cursor.replay->ticks) {
+        return false;
+    }
+    if (cursor.tick == cursor.nextChangeTick) {
+        cursor.input = cursor.nextInput;
+        readNextChange(cursor);
+    }
+    ++cursor.tick;
+    input = cursor.input;
+    return true;
+}
+
+bool playReplay(GameState& state, const Replay& replay) {
+    initGame(state, replay.config, replay.seed);
+
+    ReplayCursor cursor;
+    startPlayback(cursor, replay);
+    Direction input;
+    while (state.result == RUNNING && nextReplayInput(cursor, input)) {
+        step(state, input);
+    }
+
+    return state.ticks == replay.ticks && state.score == replay.finalScore && state.result == replay.finalResult;
+}
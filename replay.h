@@ -0,0 +1,61 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game.h"
+
+// A game is fully determined by its config, its seed and the input handed
+// to step() on every tick, so that is all a replay stores. Inputs are kept
+// as changes only: one varint per change holding the ticks since the
+// previous change shifted left by two, with the direction in the low two
+// bits. A turn every few steps costs about one byte, so an hour of play
+// (36000 steps at 100 ms) comes to a few KB.
+struct Replay {
+    GameConfig config;
+    uint64_t seed = 0;
+    std::vector<uint8_t> inputs;    // Encoded input changes
+
+    // Filled in by finishReplay() so playback can check it reproduced the game
+    long long ticks = 0;
+    int finalScore = 0;
+    StepResult finalResult = RUNNING;
+
+    // Recording state
+    Direction lastInput = RIGHT;
+    long long lastChangeTick = 0;
+};
+
+// Starts recording a game that was (re)started with this config and seed
+void beginReplay(Replay& replay, const GameConfig& config, uint64_t seed);
+
+// Call with the input of every step, in order, before or after step()
+void recordInput(Replay& replay, Direction input);
+
+// Notes the game's outcome; it may still be running if the player quit
+void finishReplay(Replay& replay, const GameState& state);
+
+bool saveReplay(const Replay& replay, const std::string& path);
+bool loadReplay(Replay& replay, const std::string& path);
+
+// Reads a replay's inputs back one tick at a time
+struct ReplayCursor {
+    const Replay* replay = nullptr;
+    size_t offset = 0;              // Next unread byte of replay->inputs
+    long long tick = 0;
+    long long nextChangeTick = -1;  // -1 once every change has been read
+    Direction nextInput = RIGHT;
+    Direction input = RIGHT;
+};
+
+void startPlayback(ReplayCursor& cursor, const Replay& replay);
+
+// Input for the next step; false once the recorded ticks are used up
+bool nextReplayInput(ReplayCursor& cursor, Direction& input);
+
+// Plays the whole replay on state (initialized here) as fast as possible.
+// Returns true when the game ends with the recorded tick count, score and result.
+bool playReplay(GameState& state, const Replay& replay);
+
+#endif
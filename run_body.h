@@ -0,0 +1,125 @@
+#ifndef RUN_BODY_H
+#define RUN_BODY_H
+
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+#include "snake_body.h"
+
+// The snake as its straight runs rather than one entry per cell, head
+// first in a growable ring. Moving the head on in a straight line only
+// moves the first run's end, and dropping the tail only shortens the last
+// run, so both are O(1) and memory follows the number of turns, not the
+// length. A move that wraps around the board edge starts a new run, so
+// every run is one rectangle on screen. Whether a cell is part of the
+// body is left to an occupancy bitmap kept beside it, as before.
+//
+// A run is 24 bytes against a SnakeSegment's 8, so this only pays off
+// while runs average more than three cells; a snake zigzagging every step
+// takes three times SnakeBody's memory. Build with -DSNAKE_RUN_BODY to
+// make it the game's body.
+class RunBody {
+public:
+    explicit RunBody(int capacity = 16) { reset(capacity); }
+
+    // Sizes the ring for capacity runs; it doubles whenever it fills up
+    void reset(int capacity) {
+        runs.assign(capacity > 0 ? capacity : 1, SnakeRun{{0, 0}, {0, 0}, 0, 0});
+        clear();
+    }
+
+    void clear() {
+        first = 0;
+        last = 0;
+        count = 0;
+        cells = 0;
+    }
+
+    void pushHead(SnakeSegment cell) {
+        if (count > 0) {
+            SnakeRun& run = runs[first];
+            int dx = cell.x - run.head.x;
+            int dy = cell.y - run.head.y;
+            // A direction is always one step, so matching the run's also
+            // rules out a move that wrapped around the board
+            bool single = run.head.x == run.tail.x && run.head.y == run.tail.y;
+            if ((dx == run.dx && dy == run.dy && !single) || (single && std::abs(dx) + std::abs(dy) == 1)) {
+                run.head = cell;
+                run.dx = dx;
+                run.dy = dy;
+                ++cells;
+                return;
+            }
+        }
+        if (count == capacity()) {
+            grow();
+        }
+        first = (first == 0 ? capacity() : first) - 1;
+        if (count == 0) {
+            last = first;
+        }
+        runs[first] = {cell, cell, 0, 0};
+        ++count;
+        ++cells;
+    }
+
+    void popTail() {
+        assert(cells > 0);
+        --cells;
+        SnakeRun& run = runs[last];
+        if (run.tail.x == run.head.x && run.tail.y == run.head.y) {
+            --count;
+            last = (last == 0 ? capacity() : last) - 1;
+        } else {
+            run.tail.x += run.dx;
+            run.tail.y += run.dy;
+        }
+    }
+
+    const SnakeSegment& head() const { return runs[first].head; }
+    const SnakeSegment& tail() const { return runs[last].tail; }
+
+    // Cells, and the runs they are stored as
+    int size() const { return cells; }
+    bool empty() const { return cells == 0; }
+    int runCount() const { return count; }
+    int capacity() const { return static_cast<int>(runs.size()); }
+
+    // Calls fn(const SnakeRun&) for every run, head first
+    template <typename Fn>
+    void forEachRun(Fn fn) const {
+        for (int i = 0, index = first; i < count; ++i) {
+            fn(runs[index]);
+            index = index + 1 == capacity() ? 0 : index + 1;
+        }
+    }
+
+    // Calls fn(SnakeSegment) for every cell, head first
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        forEachRun([&fn](const SnakeRun& run) {
+            for (int i = 0, length = runLength(run); i < length; ++i) {
+                fn(runCell(run, i));
+            }
+        });
+    }
+
+private:
+    // Doubles the ring, unwrapping it so the head run is back at slot 0
+    void grow() {
+        std::vector<SnakeRun> larger(runs.size() * 2, SnakeRun{{0, 0}, {0, 0}, 0, 0});
+        int n = 0;
+        forEachRun([&larger, &n](const SnakeRun& run) { larger[n++] = run; });
+        runs.swap(larger);
+        first = 0;
+        last = n - 1;
+    }
+
+    std::vector<SnakeRun> runs;
+    int first = 0;          // Index of the head run
+    int last = 0;           // And of the tail run
+    int count = 0;          // Runs in use
+    int cells = 0;          // Cells in all of them
+};
+
+#endif
@@ -0,0 +1,166 @@
+// Plays many independent headless games in parallel and reports aggregate
+// statistics, for tuning rules such as the bonus food duration or how many
+// regular foods earn a bonus food.
+//
+//   runner [--games N] [--threads N] [--seed S] [--controller greedy|random|chase]
+//          [--bonus-duration MS] [--food-per-bonus N] [--batch N]
+//
+// Game i always uses seed S + i, so results do not depend on the number
+// of threads.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "game.h"
+#include "bot.h"
+#include "thread_pool.h"
+
+struct RunStats {
+    long long games = 0;
+    long long totalScore = 0;
+    long long totalLength = 0;
+    long long totalTicks = 0;
+    long long deathTicks = 0;       // Ticks summed over games that actually ended
+    long long endings[BOARD_FULL + 1] = {};
+    int bestScore = 0;
+
+    void add(const GameState& game) {
+        ++games;
+        totalScore += game.score;
+        totalLength += game.snake.size();
+        totalTicks += game.ticks;
+        ++endings[game.result];
+        if (game.result != RUNNING) {
+            deathTicks += game.ticks;
+        }
+        if (game.score > bestScore) {
+            bestScore = game.score;
+        }
+    }
+
+    void merge(const RunStats& other) {
+        games += other.games;
+        totalScore += other.totalScore;
+        totalLength += other.totalLength;
+        totalTicks += other.totalTicks;
+        deathTicks += other.deathTicks;
+        for (int i = 0; i <= BOARD_FULL; ++i) {
+            endings[i] += other.endings[i];
+        }
+        if (other.bestScore > bestScore) {
+            bestScore = other.bestScore;
+        }
+    }
+};
+
+static void usage() {
+    std::cerr << "usage: runner [--games N] [--threads N] [--seed S] [--controller greedy|random|chase]\n"
+                 "              [--bonus-duration MS] [--food-per-bonus N] [--batch N]" << std::endl;
+}
+
+int main(int argc, char* args[]) {
+    long long games = 100000;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    uint64_t seed = static_cast<uint64_t>(std::time(0));
+    std::string controllerName = "greedy";
+    int batch = 64;
+
+    GameConfig config;
+    // The windowed game's level, from level.h
+    config.cols = GRID_COLS;
+    config.rows = GRID_ROWS;
+    config.tileSize = TILE_SIZE;
+    config.walls = levelWalls;
+    config.stepMs = MOVEMENT_DELAY;
+    config.bonusDurationMs = BONUS_FOOD_DURATION;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = args[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        const char* value = args[++i];
+        if (arg == "--games") {
+            games = std::atoll(value);
+        } else if (arg == "--threads") {
+            threads = std::atoi(value);
+        } else if (arg == "--seed") {
+            seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--controller") {
+            controllerName = value;
+        } else if (arg == "--bonus-duration") {
+            config.bonusDurationMs = std::atoi(value);
+        } else if (arg == "--food-per-bonus") {
+            config.foodPerBonus = std::atoi(value);
+        } else if (arg == "--batch") {
+            batch = std::atoi(value);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    Controller controller = findController(controllerName);
+    if (!controller || games <= 0 || batch <= 0 || config.bonusDurationMs <= 0 || config.foodPerBonus <= 0) {
+        usage();
+        return 1;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    // Same stall rule as the test front-end: a board's worth of steps without eating
+    const long long stallTicks = static_cast<long long>(config.cols) * config.rows;
+
+    RunStats total;
+    std::mutex totalMutex;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        for (long long first = 0; first < games; first += batch) {
+            long long last = first + batch < games ? first + batch : games;
+            pool.submit([&, first, last] {
+                // One state per batch; resetGame() reuses its buffers between games
+                GameState game;
+                initGame(game, config, seed + first);
+                RunStats stats;
+                for (long long i = first; i < last; ++i) {
+                    resetGame(game, seed + i);
+                    Rng botRng;
+                    botRng.seed(~(seed + i));
+                    playGame(game, controller, botRng, stallTicks);
+                    stats.add(game);
+                }
+                std::lock_guard<std::mutex> lock(totalMutex);
+                total.merge(stats);
+            });
+        }
+        pool.wait();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    long long deaths = total.games - total.endings[RUNNING];
+    std::cout << "games:           " << total.games << " (seed " << seed << ", " << threads << " threads, "
+              << controllerName << ")" << std::endl;
+    std::cout << "bonus duration:  " << config.bonusDurationMs << " ms, bonus every "
+              << config.foodPerBonus << " food" << std::endl;
+    std::cout << "mean score:      " << static_cast<double>(total.totalScore) / total.games << std::endl;
+    std::cout << "best score:      " << total.bestScore << std::endl;
+    std::cout << "mean length:     " << static_cast<double>(total.totalLength) / total.games << std::endl;
+    std::cout << "ticks to death:  "
+              << (deaths > 0 ? static_cast<double>(total.deathTicks) / deaths : 0.0) << std::endl;
+    std::cout << "hit wall:        " << total.endings[HIT_WALL] << std::endl;
+    std::cout << "hit self:        " << total.endings[HIT_SELF] << std::endl;
+    std::cout << "board full:      " << total.endings[BOARD_FULL] << std::endl;
+    std::cout << "stalled:         " << total.endings[RUNNING] << std::endl;
+    std::cout << "games/sec:       " << total.games / seconds << std::endl;
+    std::cout << "ticks/sec:       " << total.totalTicks / seconds << std::endl;
+    return 0;
+}
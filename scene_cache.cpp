@@ -0,0 +1,119 @@
+#include "scene_cache.h"
+
+#include <iostream>
+
+bool createSceneCache(SDL_Renderer* renderer, SceneCache& cache, int width, int height, int tileSize,
+                      SDL_Color snakeColor, SDL_Color foodColor, SDL_Color bonusFoodColor) {
+    if (!SDL_RenderTargetSupported(renderer)) {
+        return false;
+    }
+
+    cache.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!cache.texture) {
+        std::cerr << "Failed to create scene texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(cache.texture, SDL_BLENDMODE_NONE);
+
+    cache.tileSize = tileSize;
+    cache.shapes.layers.clear();
+    cache.snakeLayer = addRectLayer(cache.shapes, snakeColor);
+    cache.foodLayer = addRectLayer(cache.shapes, foodColor);
+    cache.bonusFoodLayer = addRectLayer(cache.shapes, bonusFoodColor);
+    cache.valid = false;
+    return true;
+}
+
+void destroySceneCache(SceneCache& cache) {
+    if (cache.texture) {
+        SDL_DestroyTexture(cache.texture);
+        cache.texture = nullptr;
+    }
+    cache.valid = false;
+}
+
+void invalidateSceneCache(SceneCache& cache) {
+    cache.valid = false;
+}
+
+static SDL_Rect cellRect(const SceneCache& cache, int cx, int cy) {
+    return {cx * cache.tileSize, cy * cache.tileSize, cache.tileSize, cache.tileSize};
+}
+
+// Puts the background back under one cell and forgets any body drawn there
+static void clearCell(SDL_Renderer* renderer, SceneCache& cache, SDL_Texture* background, int cx, int cy) {
+    SDL_Rect rect = cellRect(cache, cx, cy);
+    SDL_RenderCopy(renderer, background, &rect, &rect);
+    cache.drawnBody.clear(cx, cy);
+}
+
+int updateSceneCache(SDL_Renderer* renderer, SceneCache& cache, const GameSnapshot& snapshot,
+                     SDL_Texture* background) {
+    const CellBitmap& body = snapshot.snakeCells;
+    const SnakeSegment& head = snapshot.runs.front().head;
+    int repainted = 0;
+
+    SDL_SetRenderTarget(renderer, cache.texture);
+
+    if (!cache.valid || cache.drawnBody.width() != body.width() || cache.drawnBody.height() != body.height()) {
+        // Start from the bare background; the diff below then paints every body cell
+        SDL_RenderCopy(renderer, background, nullptr, nullptr);
+        cache.drawnBody.reset(body.width(), body.height());
+        cache.drawnBonusFoodActive = false;
+        cache.valid = true;
+        repainted = -1;
+    } else {
+        // Food that moved or was eaten; clearing it also lets the diff repaint a body now there
+        if (cache.drawnFood.x != snapshot.food.x || cache.drawnFood.y != snapshot.food.y) {
+            clearCell(renderer, cache, background, cache.drawnFood.x, cache.drawnFood.y);
+            ++repainted;
+        }
+        if (cache.drawnBonusFoodActive &&
+            (!snapshot.bonusFoodActive || cache.drawnBonusFood.x != snapshot.bonusFood.x ||
+             cache.drawnBonusFood.y != snapshot.bonusFood.y)) {
+            clearCell(renderer, cache, background, cache.drawnBonusFood.x, cache.drawnBonusFood.y);
+            ++repainted;
+        }
+    }
+
+    // The head cell is drawn separately by the caller, so it counts as empty here
+    int headCell = head.y * body.width() + head.x;
+
+    for (int w = 0; w < body.wordCount(); ++w) {
+        uint64_t wanted = body.word(w);
+        if (w == headCell >> 6) {
+            wanted &= ~(uint64_t(1) << (headCell & 63));
+        }
+
+        uint64_t changed = wanted ^ cache.drawnBody.word(w);
+        while (changed) {
+            int bit = __builtin_ctzll(changed);
+            changed &= changed - 1;
+
+            int cell = w * 64 + bit;
+            int cx = cell % body.width();
+            int cy = cell / body.width();
+            SDL_Rect rect = cellRect(cache, cx, cy);
+            if ((wanted >> bit) & 1) {
+                queueRect(cache.shapes, cache.snakeLayer, rect);
+            } else {
+                SDL_RenderCopy(renderer, background, &rect, &rect);
+            }
+            ++repainted;
+        }
+        cache.drawnBody.setWord(w, wanted);
+    }
+
+    // Food is redrawn every update; it is two cells at most
+    queueRect(cache.shapes, cache.foodLayer, cellRect(cache, snapshot.food.x, snapshot.food.y));
+    cache.drawnFood = snapshot.food;
+    if (snapshot.bonusFoodActive) {
+        queueRect(cache.shapes, cache.bonusFoodLayer, cellRect(cache, snapshot.bonusFood.x, snapshot.bonusFood.y));
+    }
+    cache.drawnBonusFood = snapshot.bonusFood;
+    cache.drawnBonusFoodActive = snapshot.bonusFoodActive;
+
+    flushRects(renderer, cache.shapes);
+    SDL_SetRenderTarget(renderer, nullptr);
+    return repainted < 0 ? -1 : repainted;
+}
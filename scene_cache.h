@@ -0,0 +1,53 @@
+#ifndef SCENE_CACHE_H
+#define SCENE_CACHE_H
+
+#include <SDL2/SDL.h>
+#include "cell_bitmap.h"
+#include "game.h"
+#include "rect_batch.h"
+#include "snapshot.h"
+
+// Persistent render target holding the background, the snake's body and
+// the food, for incremental rendering. Each update compares the game with
+// what the texture already shows and repaints only the cells that
+// changed, usually the new neck, the vacated tail and the food. The body
+// is diffed against the game's own snakeCells bitmap 64 cells at a time.
+// The head is left out because it is drawn interpolated between cells on
+// top of the copied texture.
+struct SceneCache {
+    SDL_Texture* texture = nullptr;
+    int tileSize = 1;
+
+    RectBatch shapes;
+    int snakeLayer = 0;
+    int foodLayer = 0;
+    int bonusFoodLayer = 0;
+
+    // What the texture currently shows
+    bool valid = false;
+    CellBitmap drawnBody;
+    SnakeSegment drawnFood;
+    SnakeSegment drawnBonusFood;
+    bool drawnBonusFoodActive = false;
+};
+
+bool createSceneCache(SDL_Renderer* renderer, SceneCache& cache, int width, int height, int tileSize,
+                      SDL_Color snakeColor, SDL_Color foodColor, SDL_Color bonusFoodColor);
+void destroySceneCache(SceneCache& cache);
+
+// Forces the next update to repaint everything, e.g. after a reset or a
+// lost render target
+void invalidateSceneCache(SceneCache& cache);
+
+// Brings the texture up to date with a snapshot taken withCells. Cleared
+// cells are restored from background, which must be the same size as the
+// cache. Returns the number of cells repainted, or -1 for a full repaint.
+//
+// What this saves is draw calls: only changed cells are drawn into the
+// texture. The whole bitmap is still scanned for changes and the whole
+// texture copied to the screen every frame, so a frame's cost still grows
+// with the board's size.
+int updateSceneCache(SDL_Renderer* renderer, SceneCache& cache, const GameSnapshot& snapshot,
+                     SDL_Texture* background);
+
+#endif
@@ -0,0 +1,172 @@
+#include "sim_thread.h"
+#include "profiler.h"
+
+// After a stall longer than this many steps the missed ones are dropped
+// rather than run back to back
+const int MAX_CATCH_UP_STEPS = 5;
+
+SimThread::~SimThread() {
+    stop();
+}
+
+void SimThread::start(GameState& game, Replay& replay, ReplayCursor* playback,
+                      std::chrono::nanoseconds stepDuration, bool snapshotCells) {
+    stop();
+    this->game = &game;
+    this->replay = &replay;
+    this->playback = playback;
+    this->stepDuration = stepDuration;
+    this->snapshotCells = snapshotCells;
+
+    stopping = false;
+    paused = false;
+    restartPending = false;
+    done.store(false, std::memory_order_relaxed);
+    inputs.drain();
+
+    // The render thread has something to draw before the first step
+    publish();
+    thread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+bool SimThread::queueInput(Direction direction, std::chrono::steady_clock::time_point pressedAt) {
+    TimedInput input;
+    input.direction = direction;
+    input.pressedAt = pressedAt;
+#ifdef SNAKE_LATENCY
+    input.handledAt = std::chrono::steady_clock::now();
+#endif
+    return inputs.push(input);
+}
+
+void SimThread::setPaused(bool paused) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->paused = paused;
+    }
+    wake.notify_one();
+}
+
+void SimThread::restart(uint64_t seed) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        restartPending = true;
+        restartSeed = seed;
+    }
+    wake.notify_one();
+}
+
+// Sleeps until the next step is due or a request arrives. Steps run with
+// the mutex released, so the setters never wait for one.
+void SimThread::run() {
+    using Clock = std::chrono::steady_clock;
+    PROFILE_THREAD("simulation");
+    Clock::time_point deadline = Clock::now() + stepDuration;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (restartPending) {
+            restartPending = false;
+            resetGame(*game, restartSeed);
+            beginReplay(*replay, game->config, restartSeed);
+            inputs.drain();     // Presses meant for the old game
+            publish();
+            deadline = Clock::now() + stepDuration;
+            continue;
+        }
+
+        if (paused) {
+            wake.wait(lock);
+            // Paused time, however it ended, does not count towards the next step
+            deadline = Clock::now() + stepDuration;
+            continue;
+        }
+
+        if (Clock::now() < deadline) {
+            // Woken early by a request or spuriously, either way look again
+            wake.wait_until(lock, deadline);
+            continue;
+        }
+
+        lock.unlock();
+        bool running = advance();
+        lock.lock();
+        if (!running) {
+            done.store(true, std::memory_order_release);
+            return;
+        }
+
+        deadline += stepDuration;
+        Clock::time_point now = Clock::now();
+        if (now - deadline > stepDuration * MAX_CATCH_UP_STEPS) {
+            deadline = now;
+        }
+    }
+}
+
+// One step with the next queued turn, then a snapshot of the result.
+// Returns false once the game is over.
+bool SimThread::advance() {
+    PROFILE_ZONE("step");
+    Direction input = game->direction;
+    TimedInput turn;
+    bool turned = false;
+    if (playback) {
+        inputs.drain();     // Keys do nothing while watching
+        if (!nextReplayInput(*playback, input)) {
+            return false;   // The recorded player quit before the game ended
+        }
+    } else {
+        turned = nextTurn(turn);
+        if (turned) {
+            input = turn.direction;
+        }
+        recordInput(*replay, input);
+    }
+
+    StepResult result = step(*game, input);
+    if (turned) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        recordLatency(turnLatency, std::chrono::duration<float, std::milli>(now - turn.pressedAt).count());
+#ifdef SNAKE_LATENCY
+        lastTurn = {turn.pressedAt, turn.handledAt, now};
+        ++turnsApplied;
+#endif
+    }
+    publish();
+    return result == RUNNING;
+}
+
+// Takes the oldest queued press that turns the snake, if any. Presses for
+// the way it is already going, or straight back onto its neck, are used
+// up and skipped.
+bool SimThread::nextTurn(TimedInput& turn) {
+    while (inputs.pop(turn)) {
+        if (turn.direction != game->direction && !isOpposite(turn.direction, game->direction)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimThread::publish() {
+    GameSnapshot& snapshot = snapshots.back();
+    takeSnapshot(snapshot, *game, snapshotCells);
+#ifdef SNAKE_LATENCY
+    snapshot.turnsApplied = turnsApplied;
+    snapshot.lastTurn = lastTurn;
+#endif
+    snapshots.publish();
+}
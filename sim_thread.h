@@ -0,0 +1,99 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "game.h"
+#include "input_queue.h"
+#include "latency.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "triple_buffer.h"
+
+// Runs a game on its own thread at a fixed step rate, so a slow frame on
+// the render thread never delays a step. After every step the thread
+// publishes a GameSnapshot through a TripleBuffer; the render thread picks
+// up the newest one with refresh() and draws it, never waiting on the
+// simulation. Nothing here touches SDL.
+//
+// Between start() and stop() the game and its replay belong to this
+// thread: the owner talks to it only through the setters below and reads
+// it only through snapshots. Key presses wait in an InputQueue and each
+// step applies the oldest one that is a real turn, so two quick presses
+// become two turns on consecutive steps. The direction each step used is
+// recorded (or taken from playback) on the simulation thread, so replays
+// stay exact.
+class SimThread {
+public:
+    SimThread() = default;
+    ~SimThread();
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    // Publishes the game's current state, then steps it every stepDuration.
+    // With playback the inputs come from the cursor, otherwise each one is
+    // recorded into replay. snapshotCells copies the occupancy bitmap into
+    // every snapshot, for readers that need more than the runs.
+    void start(GameState& game, Replay& replay, ReplayCursor* playback, std::chrono::nanoseconds stepDuration,
+               bool snapshotCells);
+
+    // Joins the thread; the game and replay are the caller's again afterwards
+    void stop();
+
+    // Safe to call from the render thread at any time. queueInput returns
+    // false if the queue was full and the press was dropped.
+    bool queueInput(Direction direction, std::chrono::steady_clock::time_point pressedAt);
+    void setPaused(bool paused);
+    void restart(uint64_t seed);            // Resets the game and starts a new recording
+
+    // True once the game has ended, or playback ran out of inputs. The
+    // thread stops stepping; stop() still has to be called.
+    bool finished() const { return done.load(std::memory_order_acquire); }
+
+    // Render thread only: picks up the newest snapshot, returning true if
+    // it changed. latest() stays valid until the next refresh().
+    bool refresh() { return snapshots.refresh(); }
+    const GameSnapshot& latest() const { return snapshots.front(); }
+
+    // Key press to the step that turned the snake, over every game since
+    // construction. Read it only while the thread is stopped.
+    const LatencySamples& inputLatency() const { return turnLatency; }
+
+private:
+    void run();
+    bool advance();
+    bool nextTurn(TimedInput& turn);
+    void publish();
+
+    GameState* game = nullptr;
+    Replay* replay = nullptr;
+    ReplayCursor* playback = nullptr;
+    std::chrono::nanoseconds stepDuration{0};
+    bool snapshotCells = false;
+
+    TripleBuffer<GameSnapshot> snapshots;
+    InputQueue inputs;
+    LatencySamples turnLatency;
+#ifdef SNAKE_LATENCY
+    long long turnsApplied = 0;
+    TurnTrace lastTurn;
+#endif
+    std::atomic<bool> done{false};
+
+    // Control requests that wake the thread, guarded by mutex
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    bool paused = false;
+    bool restartPending = false;
+    uint64_t restartSeed = 0;
+
+    std::thread thread;
+};
+
+#endif
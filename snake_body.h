@@ -0,0 +1,155 @@
+#ifndef SNAKE_BODY_H
+#define SNAKE_BODY_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+
+// Snake structure
+struct SnakeSegment {
+    int x, y;
+};
+
+// A straight stretch of the body from tail to head, each cell one step of
+// (dx, dy) on from the one before it. A single-cell run has no direction
+// yet (0, 0) and takes the first one the snake extends it in.
+struct SnakeRun {
+    SnakeSegment head;      // End nearest the snake's head
+    SnakeSegment tail;
+    int dx, dy;
+};
+
+inline int runLength(const SnakeRun& run) {
+    return std::abs(run.head.x - run.tail.x) + std::abs(run.head.y - run.tail.y) + 1;
+}
+
+// Cell i counted from the run's head end
+inline SnakeSegment runCell(const SnakeRun& run, int i) {
+    return {run.head.x - i * run.dx, run.head.y - i * run.dy};
+}
+
+// The cells a run covers as a rectangle, in cells
+inline void runBounds(const SnakeRun& run, int& x, int& y, int& w, int& h) {
+    x = std::min(run.head.x, run.tail.x);
+    y = std::min(run.head.y, run.tail.y);
+    w = std::abs(run.head.x - run.tail.x) + 1;
+    h = std::abs(run.head.y - run.tail.y) + 1;
+}
+
+// Circular buffer holding the snake from head to tail. Pushing a new head
+// and dropping the tail are both O(1); pushHead() needs room, which the
+// owner makes with grow() when the buffer is full, so the capacity follows
+// the longest snake rather than the size of the board.
+//
+// New heads are written one slot *before* the current head, which keeps
+// head-to-tail order ascending in memory: the body is at most two
+// contiguous runs that forEachSpan() hands out as plain arrays.
+class SnakeBody {
+public:
+    explicit SnakeBody(int capacity = 0) { reset(capacity); }
+
+    void reset(int capacity) {
+        segments.assign(capacity > 0 ? capacity : 1, SnakeSegment{0, 0});
+        first = 0;
+        count = 0;
+    }
+
+    void clear() {
+        first = 0;
+        count = 0;
+    }
+
+    // Doubles the capacity, keeping the segments in order
+    void grow() {
+        std::vector<SnakeSegment> larger(segments.size() * 2, SnakeSegment{0, 0});
+        int n = 0;
+        forEach([&larger, &n](const SnakeSegment& segment) { larger[n++] = segment; });
+        segments.swap(larger);
+        first = 0;
+    }
+
+    void pushHead(SnakeSegment segment) {
+        assert(count < capacity());
+        first = (first == 0 ? capacity() : first) - 1;
+        segments[first] = segment;
+        ++count;
+    }
+
+    void popTail() {
+        assert(count > 0);
+        --count;
+    }
+
+    const SnakeSegment& head() const { return segments[first]; }
+    const SnakeSegment& tail() const { return (*this)[count - 1]; }
+
+    // Segment i counted from the head
+    const SnakeSegment& operator[](int i) const {
+        int index = first + i;
+        if (index >= capacity()) {
+            index -= capacity();
+        }
+        return segments[index];
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    int capacity() const { return static_cast<int>(segments.size()); }
+
+    // Calls fn(const SnakeSegment* data, int n) once or twice, head first
+    template <typename Fn>
+    void forEachSpan(Fn fn) const {
+        int firstRun = capacity() - first;
+        if (count <= firstRun) {
+            if (count > 0) {
+                fn(segments.data() + first, count);
+            }
+        } else {
+            fn(segments.data() + first, firstRun);
+            fn(segments.data(), count - firstRun);
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        forEachSpan([&fn](const SnakeSegment* data, int n) {
+            for (int i = 0; i < n; ++i) {
+                fn(data[i]);
+            }
+        });
+    }
+
+    // Calls fn(const SnakeRun&) for every straight run, head first, so the
+    // snapshot and renderer can draw it the same way as a RunBody. A move
+    // that wrapped around the board edge starts a new run.
+    template <typename Fn>
+    void forEachRun(Fn fn) const {
+        if (count == 0) {
+            return;
+        }
+        SnakeRun run = {head(), head(), 0, 0};
+        for (int i = 1; i < count; ++i) {
+            const SnakeSegment& cell = (*this)[i];
+            int dx = run.tail.x - cell.x;
+            int dy = run.tail.y - cell.y;
+            bool single = run.head.x == run.tail.x && run.head.y == run.tail.y;
+            if (std::abs(dx) + std::abs(dy) == 1 && (single || (dx == run.dx && dy == run.dy))) {
+                run.tail = cell;
+                run.dx = dx;
+                run.dy = dy;
+            } else {
+                fn(run);
+                run = {cell, cell, 0, 0};
+            }
+        }
+        fn(run);
+    }
+
+private:
+    std::vector<SnakeSegment> segments;
+    int first = 0; // Index of the head
+    int count = 0;
+};
+
+#endif
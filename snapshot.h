@@ -0,0 +1,62 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <chrono>
+#include <vector>
+#include "cell_bitmap.h"
+#include "game.h"
+#include "latency.h"
+
+// Everything a front-end draws, copied out of a GameState after a step so
+// another thread can render it while the game moves on. The level is not
+// included; it does not change once initGame() has loaded it.
+struct GameSnapshot {
+    std::vector<SnakeRun> runs;         // Head first, one per straight stretch of the body
+    int length = 0;                     // Cells in all of them
+    CellBitmap snakeCells;              // Empty unless taken withCells, see takeSnapshot()
+    SnakeSegment previousHead;
+    SnakeSegment food, bonusFood;
+    bool bonusFoodActive = false;
+
+    Direction direction = RIGHT;
+    int score = 0;
+    long long ticks = 0;
+    StepResult result = RUNNING;
+
+    std::chrono::steady_clock::time_point steppedAt;    // When the step that produced it ran
+
+#ifdef SNAKE_LATENCY
+    // Filled in by SimThread: the newest turn applied and how many there
+    // have been, so the renderer can tell when it first shows one
+    long long turnsApplied = 0;
+    TurnTrace lastTurn;
+#endif
+};
+
+// Reuses the snapshot's buffers, so once they have grown to the snake's
+// number of runs this does not allocate. The occupancy bitmap is a whole
+// board's worth of bits (2 MB at 4096 x 4096), so it is only copied
+// withCells, for the incremental renderer that diffs against it; drawing
+// anything else needs only the runs.
+inline void takeSnapshot(GameSnapshot& snapshot, const GameState& state, bool withCells) {
+    snapshot.runs.clear();
+    state.snake.forEachRun([&snapshot](const SnakeRun& run) { snapshot.runs.push_back(run); });
+    snapshot.length = state.snake.size();
+    if (withCells) {
+        snapshot.snakeCells = state.snakeCells;
+    } else if (snapshot.snakeCells.width() != 0) {
+        snapshot.snakeCells.reset(0, 0);
+    }
+    snapshot.previousHead = state.previousHead;
+    snapshot.food = state.food;
+    snapshot.bonusFood = state.bonusFood;
+    snapshot.bonusFoodActive = state.bonusFoodActive;
+
+    snapshot.direction = state.direction;
+    snapshot.score = state.score;
+    snapshot.ticks = state.ticks;
+    snapshot.result = state.result;
+    snapshot.steppedAt = std::chrono::steady_clock::now();
+}
+
+#endif
@@ -1,464 +1,475 @@
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
+// Headless front-end for the alternate layout: three walls, a bonus food
+// after every second regular food and bonus food worth 10 points. It first
+// checks each snake body type against a std::deque, and the rules on small
+// scripted games (walls, self-collision, food placement, wrap-around, the
+// bonus timer, food on an endless board the snake has coiled over and a
+// known seed's result). Then a greedy bot plays a batch of games with no
+// window and the results and simulation speed are printed. Exits non-zero if any check fails, so
+// rule and engine changes can be checked without playing by hand.
+//
+//   test [games] [seed]
+#include <algorithm>
 #include <iostream>
 #include <vector>
+#include <deque>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
-
-#undef main
-
-// Direction enum declaration
-enum Direction {
-    UP,
-    DOWN,
-    LEFT,
-    RIGHT
-};
-
-// Constants
-const int SCREEN_WIDTH = 640;
-const int SCREEN_HEIGHT = 480;
-const int TILE_SIZE = 10;
-const int REGULAR_FOOD_SIZE = TILE_SIZE;
-const int BONUS_FOOD_SIZE = TILE_SIZE; // Double the size
-const int TARGET_FRAME_RATE = 60;          // Frames per second
-const int MOVEMENT_DELAY = 100;            // Milliseconds delay between movements
-const int BONUS_FOOD_DURATION = 6000;      // 4 seconds
-
-// Snake structure
-struct SnakeSegment {
-    int x, y;
+#include "game.h"
+#include "bot.h"
+
+// A layout of its own, on the same board and timing as the game's level
+const std::vector<WallRect> alternateWalls = {
+    {200, 350, 20, 200},
+    {400, 120, 20, 200},
+    {200, 350, 200, 20},
 };
 
-// Function prototypes
-void spawnFood();
-void spawnBonusFood();
-void eatBonusFood();
-void update();
-void render();
-void handleInput();
-void handleBonusFoodDuration();
-void displayGameOver();
-bool showWelcomeScreen();
-
-// Obstacle rectangles
-SDL_Rect wallRect1{200, 350, 20, 200};
-SDL_Rect wallRect2{400, 120, 20, 200};
-SDL_Rect wallRect3{200, 350, 200, 20};
-
-// Global variables
-SDL_Window* window;
-SDL_Renderer* renderer;
-std::vector<SnakeSegment> snake;
-SnakeSegment food, bonusFood;
-Direction snakeDirection = Direction::RIGHT; // Initialize the direction
-int score = 0;
-int regularFoodEaten = 0;
-Uint32 bonusFoodTimer = 0;
-bool bonusFoodActive = false;
-bool gamePaused = false;
-
-// TTF Font and Textures
-TTF_Font* font;
-SDL_Texture* scoreTexture;
-SDL_Texture* levelTexture;
-SDL_Texture* welcomeTexture;
-
-// Button Rectangles
-SDL_Rect yesButton = {150, 350, 100, 50};
-SDL_Rect noButton = {400, 350, 100, 50};
+// What a greedy game on the alternate layout with this seed comes to, as
+// it has since the rules were split out of main.cpp
+const uint64_t KNOWN_SEED = 1;
+const int KNOWN_SCORE = 530;
+const long long KNOWN_TICKS = 1617;
 
-int main(int argc, char* args[]) {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
-        return 1;
-    }
+static int failures = 0;
 
-    if (TTF_Init() < 0) {
-        std::cerr << "TTF initialization failed: " << TTF_GetError() << std::endl;
-        SDL_Quit();
-        return 1;
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cout << "FAIL: " << what << std::endl;
+        ++failures;
     }
+}
 
-    window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-                              SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-
-    std::srand(static_cast<unsigned>(std::time(0)));
-
-    snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-
-    spawnFood();
+static GameConfig alternateLayout() {
+    GameConfig config;
+    config.cols = GRID_COLS;
+    config.rows = GRID_ROWS;
+    config.tileSize = TILE_SIZE;
+    config.walls = alternateWalls;
+    config.stepMs = MOVEMENT_DELAY;
+    config.bonusDurationMs = BONUS_FOOD_DURATION;
+    config.foodPerBonus = 2;
+    config.bonusScore = 10;
+    return config;
+}
 
-    // Load font
-    font = TTF_OpenFont("Moonlight.otf", 40); // Replace "arial.ttf" with the path to your font file
+// An open board with no walls and no bonus food to get in the way
+static GameConfig openBoard() {
+    GameConfig config;
+    config.foodPerBonus = 1000;
+    return config;
+}
 
-    if (!font) {
-        std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        TTF_Quit();
-        SDL_Quit();
-        return 1;
+// Drives body and a std::deque with the same pushes and pops: a random
+// walk on a cols x rows board (0 x 0 for endless) that turns often, wraps
+// at the edges and grows and shrinks in phases, then drops to nothing and
+// starts again. Returns false at the first difference in size, head, tail
+// or the cells forEach and forEachRun give, head first.
+template <typename Body>
+static bool matchesDeque(Body& body, int cols, int rows, uint64_t seed) {
+    const int MOVE_X[4] = {0, 0, -1, 1};
+    const int MOVE_Y[4] = {-1, 1, 0, 0};
+    Rng rng;
+    rng.seed(seed);
+    std::deque<SnakeSegment> cells;
+    int move = RIGHT;
+
+    auto push = [&]() {
+        SnakeSegment head = {1, 1};
+        if (!cells.empty()) {
+            if (rng.below(3) == 0) {
+                move = rng.below(4);
+            }
+            head = {cells.front().x + MOVE_X[move], cells.front().y + MOVE_Y[move]};
+            if (cols > 0) {
+                head.x = (head.x + cols) % cols;
+                head.y = (head.y + rows) % rows;
+            }
+        }
+        body.pushHead(head);
+        cells.push_front(head);
+    };
+    auto pop = [&]() {
+        body.popTail();
+        cells.pop_back();
+    };
+    auto same = [&]() {
+        if (body.size() != static_cast<int>(cells.size())) {
+            return false;
+        }
+        if (cells.empty()) {
+            return true;
+        }
+        if (body.head().x != cells.front().x || body.head().y != cells.front().y ||
+            body.tail().x != cells.back().x || body.tail().y != cells.back().y) {
+            return false;
+        }
+        size_t i = 0;
+        bool ok = true;
+        body.forEach([&](const SnakeSegment& cell) {
+            ok = ok && i < cells.size() && cell.x == cells[i].x && cell.y == cells[i].y;
+            ++i;
+        });
+        ok = ok && i == cells.size();
+        i = 0;
+        body.forEachRun([&](const SnakeRun& run) {
+            for (int j = 0, length = runLength(run); j < length; ++j) {
+                SnakeSegment cell = runCell(run, j);
+                ok = ok && i < cells.size() && cell.x == cells[i].x && cell.y == cells[i].y;
+                ++i;
+            }
+        });
+        return ok && i == cells.size();
+    };
+
+    // Grow, drain most of it so the storage's start has moved on, then
+    // grow well past where it started, so growing happens while wrapped
+    for (int i = 0; i < 20; ++i) {
+        push();
     }
-
-// Show welcome screen
-    bool startGame = showWelcomeScreen();
-
-    if (!startGame) {
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        TTF_CloseFont(font);
-        TTF_Quit();
-        SDL_Quit();
-        return 0;
+    for (int i = 0; i < 15; ++i) {
+        pop();
     }
-
-    snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-
-    spawnFood();
-
-    // Main game loop
-    bool quit = false;
-    SDL_Event e;
-
-    while (!quit) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                quit = true;
-            } else if (e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_p) {
-                    gamePaused = !gamePaused;
-                }
-            }else if (e.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-
-                if (mouseX >= yesButton.x && mouseX <= yesButton.x + yesButton.w &&
-                    mouseY >= yesButton.y && mouseY <= yesButton.y + yesButton.h) {
-                    startGame = true;
-                    snake.clear();
-                    snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-                    spawnFood();
-                    score = 0;
-                    regularFoodEaten = 0;
-                    bonusFoodActive = false;
-                    bonusFoodTimer = 0;
-                    gamePaused = false;
-                } else if (mouseX >= noButton.x && mouseX <= noButton.x + noButton.w &&
-                           mouseY >= noButton.y && mouseY <= noButton.y + noButton.h) {
-                    startGame = false;
-                    quit = true;
-                }
-            }
-
-            handleInput();
+    for (int i = 0; i < 100; ++i) {
+        push();
+        if (!same()) {
+            return false;
         }
+    }
 
-        if (!gamePaused && startGame) {
-            update();
+    // Phases that mostly grow, hold or mostly shrink
+    const int pushChance[] = {7, 5, 3, 5};
+    for (int i = 0; i < 8000; ++i) {
+        if (cells.empty() || rng.below(10) < pushChance[i / 1000 % 4]) {
+            push();
+        } else {
+            pop();
+        }
+        if (!same()) {
+            return false;
         }
-
-        render();
-
-        SDL_Delay(MOVEMENT_DELAY);
     }
 
-    // Cleanup and exit
-    displayGameOver();
-
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    TTF_CloseFont(font);
-    TTF_Quit();
-    SDL_Quit();
-    return 0;
-}
-
-bool showWelcomeScreen() {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string welcomeText = " GAME START?";
-
-    // Render welcome message
-    SDL_Surface* welcomeSurface = TTF_RenderText_Solid(font, welcomeText.c_str(), textColor);
-    welcomeTexture = SDL_CreateTextureFromSurface(renderer, welcomeSurface);
-
-    SDL_Rect welcomeRect = {(SCREEN_WIDTH - welcomeSurface->w) / 2, (SCREEN_HEIGHT - welcomeSurface->h) / 2,
-                             welcomeSurface->w, welcomeSurface->h};
-    SDL_RenderCopy(renderer, welcomeTexture, nullptr, &welcomeRect);
-
-    SDL_FreeSurface(welcomeSurface);
-
-    // Render buttons
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_RenderFillRect(renderer, &yesButton);
-
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    SDL_RenderFillRect(renderer, &noButton);
-
-    // Render button text
-    std::string yesButtonText = "Yes";
-    SDL_Surface* yesButtonSurface = TTF_RenderText_Solid(font, yesButtonText.c_str(), textColor);
-    SDL_Texture* yesButtonTexture = SDL_CreateTextureFromSurface(renderer, yesButtonSurface);
-
-    SDL_Rect yesButtonRect = {yesButton.x + (yesButton.w - yesButtonSurface->w) / 2,
-                              yesButton.y + (yesButton.h - yesButtonSurface->h) / 2,
-                              yesButtonSurface->w, yesButtonSurface->h};
-    SDL_RenderCopy(renderer, yesButtonTexture, nullptr, &yesButtonRect);
-
-    SDL_FreeSurface(yesButtonSurface);
-
-    std::string noButtonText = "No";
-    SDL_Surface* noButtonSurface = TTF_RenderText_Solid(font, noButtonText.c_str(), textColor);
-    SDL_Texture* noButtonTexture = SDL_CreateTextureFromSurface(renderer, noButtonSurface);
-
-    SDL_Rect noButtonRect = {noButton.x + (noButton.w - noButtonSurface->w) / 2,
-                             noButton.y + (noButton.h - noButtonSurface->h) / 2,
-                             noButtonSurface->w, noButtonSurface->h};
-    SDL_RenderCopy(renderer, noButtonTexture, nullptr, &noButtonRect);
-
-    SDL_FreeSurface(noButtonSurface);
-
-    SDL_RenderPresent(renderer);
-
-    // Wait for user input
-    SDL_Event e;
-    while (true) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                return false;
-            } else if (e.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-
-                if (mouseX >= yesButton.x && mouseX <= yesButton.x + yesButton.w &&
-                    mouseY >= yesButton.y && mouseY <= yesButton.y + yesButton.h) {
-                    return true;
-                } else if (mouseX >= noButton.x && mouseX <= noButton.x + noButton.w &&
-                           mouseY >= noButton.y && mouseY <= noButton.y + noButton.h) {
-                    return false;
-                }
-            }
+    while (!cells.empty()) {
+        pop();
+        if (!same()) {
+            return false;
         }
     }
+    for (int i = 0; i < 50; ++i) {
+        push();
+        if (!same()) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void spawnFood() {
-    int maxX = (SCREEN_WIDTH - 2 * TILE_SIZE) / TILE_SIZE;
-    int maxY = (SCREEN_HEIGHT - 2 * TILE_SIZE) / TILE_SIZE;
-
-    food.x = TILE_SIZE + rand() % maxX * TILE_SIZE;
-    food.y = TILE_SIZE + rand() % maxY * TILE_SIZE;
+static void checkBodies() {
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        SnakeBody segments(1 << 16);
+        check(matchesDeque(segments, 24, 16, seed), "SnakeBody matches a deque on a wrapping board");
+        segments.clear();
+        check(matchesDeque(segments, 0, 0, seed), "SnakeBody matches a deque on an endless board");
+
+        RunBody runs(1);
+        check(matchesDeque(runs, 24, 16, seed), "RunBody matches a deque on a wrapping board");
+        runs.reset(1);
+        check(matchesDeque(runs, 0, 0, seed), "RunBody matches a deque on an endless board");
+
+        // Starts at the smallest buffer, 32 moves, so the walk wraps it and grows it
+        DirectionBody packed(1);
+        packed.setBoard(24, 16);
+        check(matchesDeque(packed, 24, 16, seed), "DirectionBody matches a deque on a wrapping board");
+        packed.reset(1);
+        packed.setBoard(0, 0);
+        check(matchesDeque(packed, 0, 0, seed), "DirectionBody matches a deque on an endless board");
+    }
 }
 
-void spawnBonusFood() {
-    int maxX = (SCREEN_WIDTH - 2 * TILE_SIZE) / TILE_SIZE;
-    int maxY = (SCREEN_HEIGHT - 2 * TILE_SIZE) / TILE_SIZE;
-
-    bonusFood.x = TILE_SIZE + rand() % maxX * TILE_SIZE;
-    bonusFood.y = TILE_SIZE + rand() % maxY * TILE_SIZE;
-
-    bonusFoodActive = true;
-    bonusFoodTimer = SDL_GetTicks();
+// Puts the food in front of the head and steps onto it
+static void eatAhead(GameState& game) {
+    game.food = nextCell(game, game.snake.head(), game.direction);
+    step(game, game.direction);
 }
 
-void eatBonusFood() {
-    bonusFoodActive = false;
-    // Add any other logic you may need after eating the bonus food
+static void checkWallHit() {
+    // One wall cell 8 cells right of the starting head at (32, 24)
+    GameConfig config = openBoard();
+    config.walls = {{400, 240, TILE_SIZE, TILE_SIZE}};
+    GameState game;
+    initGame(game, config, 1);
+    game.food = {1, 1};
+    for (int i = 0; i < 7; ++i) {
+        step(game, RIGHT);
+    }
+    check(game.result == RUNNING && game.snake.head().x == 39, "snake runs up to the wall");
+    check(step(game, RIGHT) == HIT_WALL, "moving into a wall ends the game");
+    check(game.snake.head().x == 39 && game.ticks == 8, "the head stays in front of the wall");
+    check(step(game, RIGHT) == HIT_WALL && game.ticks == 8, "a finished game does not step");
 }
 
-void update() {
-    SnakeSegment head = snake.front();
-    switch (snakeDirection) {
-        case Direction::UP:
-            head.y -= TILE_SIZE;
-            break;
-        case Direction::DOWN:
-            head.y += TILE_SIZE;
-            break;
-        case Direction::LEFT:
-            head.x -= TILE_SIZE;
-            break;
-        case Direction::RIGHT:
-            head.x += TILE_SIZE;
-            break;
+static void checkSelfCollision() {
+    GameState game;
+    initGame(game, openBoard(), 1);
+    for (int i = 0; i < 4; ++i) {
+        eatAhead(game);
     }
-
-    /*if (head.x < TILE_SIZE || head.x >= SCREEN_WIDTH - TILE_SIZE ||
-        head.y < TILE_SIZE || head.y >= SCREEN_HEIGHT - TILE_SIZE) {
-        displayGameOver();
-        return;
-    }*/
-
-    // Wrap around the screen if the head hits the boundary
-    if (head.x < 0) {
-        head.x = SCREEN_WIDTH - TILE_SIZE;
-    } else if (head.x >= SCREEN_WIDTH) {
-        head.x = 0;
+    check(game.snake.size() == 5 && game.score == 40, "each food grows the snake by one");
+    game.food = {1, 1};
+
+    step(game, LEFT);
+    check(game.result == RUNNING && game.direction == RIGHT, "reversing onto the neck is ignored");
+    step(game, DOWN);
+    step(game, LEFT);
+    check(game.result == RUNNING, "turning beside the body is fine");
+    check(step(game, UP) == HIT_SELF, "moving into the body ends the game");
+
+    // The tail moves off its cell in the same step, so chasing it is fine
+    initGame(game, openBoard(), 1);
+    for (int i = 0; i < 3; ++i) {
+        eatAhead(game);
     }
+    game.food = {1, 1};
+    step(game, DOWN);
+    step(game, LEFT);
+    step(game, UP);
+    check(game.result == RUNNING, "moving into the cell the tail just left is fine");
+}
 
-    if (head.y < 0) {
-        head.y = SCREEN_HEIGHT - TILE_SIZE;
-    } else if (head.y >= SCREEN_HEIGHT) {
-        head.y = 0;
+static void checkWrapAround() {
+    GameState game;
+    initGame(game, openBoard(), 1);
+    game.food = {1, 1};
+    for (int i = 0; i < 32; ++i) {
+        step(game, RIGHT);
     }
-
-    if ((head.x + TILE_SIZE > wallRect1.x && head.x < wallRect1.x + wallRect1.w &&
-         head.y + TILE_SIZE > wallRect1.y && head.y < wallRect1.y + wallRect1.h) ||
-        (head.x + TILE_SIZE > wallRect2.x && head.x < wallRect2.x + wallRect2.w &&
-         head.y + TILE_SIZE > wallRect2.y && head.y < wallRect2.y + wallRect2.h) ||
-        (head.x + TILE_SIZE > wallRect3.x && head.x < wallRect3.x + wallRect3.w &&
-         head.y + TILE_SIZE > wallRect3.y && head.y < wallRect3.y + wallRect3.h)) {
-        displayGameOver();
-        return;
+    check(game.result == RUNNING && game.snake.head().x == 0 && game.snake.head().y == 24,
+          "leaving the right edge comes back on the left");
+    for (int i = 0; i < 25; ++i) {
+        step(game, UP);
     }
+    check(game.result == RUNNING && game.snake.head().x == 0 && game.snake.head().y == 47,
+          "leaving the top edge comes back at the bottom");
+}
 
-    if (head.x == food.x && head.y == food.y) {
-        regularFoodEaten++;
-
-        if (regularFoodEaten == 2) {
-            regularFoodEaten = 0;
-            score += 10;
-            spawnFood();
-            spawnBonusFood();
-        } else {
-            score += 10;
-            spawnFood();
-        }
-    } else if (bonusFoodActive && head.x == bonusFood.x && head.y == bonusFood.y) {
-        score += 10;
-        bonusFoodActive = false;
-        spawnFood();
-    } else {
-        snake.pop_back();
+static void checkBonusTimer() {
+    GameConfig config = openBoard();
+    config.foodPerBonus = 1;
+    config.bonusDurationMs = 450;           // Rounds up to 5 steps
+    GameState game;
+    initGame(game, config, 1);
+    eatAhead(game);
+    check(game.bonusFoodActive, "a bonus food appears after foodPerBonus foods");
+
+    // Keep both foods off the row the snake runs along
+    game.food = {1, 1};
+    game.bonusFood = {2, 2};
+    for (int i = 0; i < 4; ++i) {
+        step(game, RIGHT);
     }
+    check(game.bonusFoodActive, "the bonus food stays until its time is up");
+    step(game, RIGHT);
+    check(!game.bonusFoodActive && game.ticks == 6, "the bonus food goes once its time is up");
+    check(game.result == RUNNING && game.score == config.foodScore, "an expired bonus food scores nothing");
+}
 
-    for (const auto& segment : snake) {
-        if (head.x == segment.x && head.y == segment.y) {
-            displayGameOver();
-            return;
+// A snake grown in a spiral over the whole square its food window covers,
+// head in the middle, so every random spot food could be drawn on is
+// taken. The food must still go on an open cell nearby, never end the game.
+static void checkEndlessCoil() {
+    const int SIDE = 21;
+    GameConfig config = openBoard();
+    config.endless = true;
+    config.cols = SIDE;
+    config.rows = SIDE;
+    GameState game;
+    initGame(game, config, 1);
+
+    // Clockwise from the top-left corner (0, 0), turning right at the edge
+    // of the square or the body, which ends in its middle
+    const Direction turnRight[] = {RIGHT, LEFT, UP, DOWN};      // Indexed by Direction
+    std::vector<bool> visited(SIDE * SIDE, false);
+    visited[0] = true;
+    Direction direction = RIGHT;
+    bool grew = true;
+    for (int i = 1; i < SIDE * SIDE && grew; ++i) {
+        for (int turns = 0; turns < 4; ++turns) {
+            SnakeSegment next = nextCell(game, game.snake.head(), direction);
+            if (next.x >= 0 && next.y >= 0 && next.x < SIDE && next.y < SIDE && !visited[next.y * SIDE + next.x]) {
+                visited[next.y * SIDE + next.x] = true;
+                break;
+            }
+            direction = turnRight[direction];
         }
+        game.food = nextCell(game, game.snake.head(), direction);
+        grew = step(game, direction) == RUNNING && game.snake.size() == i + 1;
     }
-
-    snake.insert(snake.begin(), head);
-
-    handleBonusFoodDuration();
+    const SnakeSegment& head = game.snake.head();
+    check(grew && head.x == SIDE / 2 && head.y == SIDE / 2, "the snake coils over its whole food window");
+    check(game.result == RUNNING, "an endless board never fills up");
+    check(!isSnakeCell(game, game.food.x, game.food.y) && !isWallAt(game, game.food.x, game.food.y) &&
+          std::abs(game.food.x - head.x) <= SIDE / 2 + 1 && std::abs(game.food.y - head.y) <= SIDE / 2 + 1,
+          "food lands on the nearest open cells when its window is full");
 }
 
-void render() {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    SDL_SetRenderDrawColor(renderer, 0, 128, 128, 0);
-    SDL_Rect topWall = {0, 0, SCREEN_WIDTH, TILE_SIZE};
-    SDL_Rect bottomWall = {0, SCREEN_HEIGHT - TILE_SIZE, SCREEN_WIDTH, TILE_SIZE};
-    SDL_Rect leftWall = {0, 0, TILE_SIZE, SCREEN_HEIGHT};
-    SDL_Rect rightWall = {SCREEN_WIDTH - TILE_SIZE, 0, TILE_SIZE, SCREEN_HEIGHT};
-    SDL_RenderFillRect(renderer, &topWall);
-    SDL_RenderFillRect(renderer, &bottomWall);
-    SDL_RenderFillRect(renderer, &leftWall);
-    SDL_RenderFillRect(renderer, &rightWall);
-
-    SDL_SetRenderDrawColor(renderer, 0, 0, 128, 255);
-    SDL_RenderFillRect(renderer, &wallRect1);
-    SDL_SetRenderDrawColor(renderer, 255, 0, 128, 255);
-    SDL_RenderFillRect(renderer, &wallRect2);
-    SDL_SetRenderDrawColor(renderer, 128, 0, 128, 255);
-    SDL_RenderFillRect(renderer, &wallRect3);
-
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    for (const auto& segment : snake) {
-        SDL_Rect rect = {segment.x, segment.y, TILE_SIZE, TILE_SIZE};
-        SDL_RenderFillRect(renderer, &rect);
+// Heads right across many chunks of an endless board, stepping around
+// walls, eating whatever is ahead until it is LENGTH long. The snake only
+// ever spans a few chunks, so only those few should be live, and the
+// chunks it leaves behind should be reused from the pool rather than
+// allocated afresh.
+static void checkEndlessChunks() {
+    const int CHUNKS_CROSSED = 50;
+    const int LENGTH = 100;             // Spans four or five chunks in a line
+    const int MOST_CHUNKS = 8;
+    GameConfig config = openBoard();
+    config.endless = true;
+    GameState game;
+    initGame(game, config, 1);
+
+    const Direction preferred[] = {RIGHT, UP, DOWN};
+    int mostLive = 0;
+    while (game.result == RUNNING && game.snake.head().x < CHUNKS_CROSSED * CHUNK_SIZE) {
+        Direction direction = game.direction;
+        for (Direction candidate : preferred) {
+            SnakeSegment next = nextCell(game, game.snake.head(), candidate);
+            if (!isOpposite(candidate, game.direction) && !isWallAt(game, next.x, next.y) &&
+                !isSnakeCell(game, next.x, next.y)) {
+                direction = candidate;
+                break;
+            }
+        }
+        if (game.snake.size() < LENGTH) {
+            game.food = nextCell(game, game.snake.head(), direction);
+        }
+        step(game, direction);
+        mostLive = std::max(mostLive, game.world.liveChunks());
     }
+    check(game.result == RUNNING && game.snake.size() == LENGTH, "the snake crosses an endless board's chunks");
+    check(mostLive <= MOST_CHUNKS, "only the chunks under the snake are live");
+    check(game.world.pooledChunks() <= MOST_CHUNKS, "chunks the snake leaves are reused");
+}
 
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_Rect foodRect = {food.x, food.y, REGULAR_FOOD_SIZE, REGULAR_FOOD_SIZE};
-    SDL_RenderFillRect(renderer, &foodRect);
+// Food and bonus food only ever land on open cells inside the border
+static bool foodIsOnOpenCell(const GameState& game, SnakeSegment food) {
+    return food.x > 0 && food.y > 0 && food.x < game.config.cols - 1 && food.y < game.config.rows - 1 &&
+           !isWallAt(game, food.x, food.y) && !isSnakeCell(game, food.x, food.y);
+}
 
-    if (bonusFoodActive) {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-        SDL_Rect bonusFoodRect = {bonusFood.x, bonusFood.y, BONUS_FOOD_SIZE, BONUS_FOOD_SIZE};
-        SDL_RenderFillRect(renderer, &bonusFoodRect);
+static void checkFoodPlacement(const GameConfig& config) {
+    GameState game;
+    initGame(game, config, 1);
+    Controller controller = findController("greedy");
+    Rng botRng;
+    bool open = true;
+    for (int i = 0; i < 50 && open; ++i) {
+        resetGame(game, KNOWN_SEED + i);
+        open = foodIsOnOpenCell(game, game.food);
+        for (long long stall = 0; game.result == RUNNING && open && stall < config.cols * config.rows; ++stall) {
+            int score = game.score;
+            step(game, controller(game, botRng));
+            if (game.score != score) {
+                stall = 0;
+            }
+            // Only the cell the snake hit can be under it once the game is over
+            if (game.result == RUNNING) {
+                open = foodIsOnOpenCell(game, game.food) &&
+                       (!game.bonusFoodActive || foodIsOnOpenCell(game, game.bonusFood)) &&
+                       !(game.bonusFoodActive && game.food.x == game.bonusFood.x && game.food.y == game.bonusFood.y);
+            }
+        }
     }
-
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string scoreText = "Score: " + std::to_string(score);
-
-    // Render score
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(font, scoreText.c_str(), textColor);
-    scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-
-    SDL_Rect scoreRect = {10, 10, scoreSurface->w, scoreSurface->h};
-    SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
-
-    SDL_FreeSurface(scoreSurface);
-
-    // Render level board (you can customize it based on your game's logic)
-    std::string levelText = "Level: 1"; // Customize based on your game's logic
-    SDL_Surface* levelSurface = TTF_RenderText_Solid(font, levelText.c_str(), textColor);
-    levelTexture = SDL_CreateTextureFromSurface(renderer, levelSurface);
-
-    SDL_Rect levelRect = {SCREEN_WIDTH - levelSurface->w - 10, 10, levelSurface->w, levelSurface->h};
-    SDL_RenderCopy(renderer, levelTexture, nullptr, &levelRect);
-
-    SDL_FreeSurface(levelSurface);
-
-    SDL_RenderPresent(renderer);
+    check(open, "food never spawns on the snake, a wall or the other food");
 }
 
-void handleInput() {
-    const Uint8* currentKeyStates = SDL_GetKeyboardState(nullptr);
-
-    if (currentKeyStates[SDL_SCANCODE_UP] && snakeDirection != Direction::DOWN) {
-        snakeDirection = Direction::UP;
-    } else if (currentKeyStates[SDL_SCANCODE_DOWN] && snakeDirection != Direction::UP) {
-        snakeDirection = Direction::DOWN;
-    } else if (currentKeyStates[SDL_SCANCODE_LEFT] && snakeDirection != Direction::RIGHT) {
-        snakeDirection = Direction::LEFT;
-    } else if (currentKeyStates[SDL_SCANCODE_RIGHT] && snakeDirection != Direction::LEFT) {
-        snakeDirection = Direction::RIGHT;
+static void checkKnownSeed(const GameConfig& config) {
+    GameState game;
+    initGame(game, config, KNOWN_SEED);
+    Rng botRng;
+    playGame(game, findController("greedy"), botRng, static_cast<long long>(config.cols) * config.rows);
+    check(game.score == KNOWN_SCORE && game.ticks == KNOWN_TICKS, "a known seed plays out the same as before");
+    if (game.score != KNOWN_SCORE || game.ticks != KNOWN_TICKS) {
+        std::cout << "      score " << game.score << " ticks " << game.ticks << ", expected " << KNOWN_SCORE
+                  << " and " << KNOWN_TICKS << std::endl;
     }
-}
 
-void handleBonusFoodDuration() {
-    if (bonusFoodActive && (SDL_GetTicks() - bonusFoodTimer >= BONUS_FOOD_DURATION)) {
-        bonusFoodActive = false;
-        spawnFood();
+    // resetGame() undoes a short game's changes to the free cells rather
+    // than rebuilding them, and a long one's by rebuilding; either way the
+    // known seed must play out the same afterwards
+    const int earlierTicks[] = {50, 5000};
+    for (int ticks : earlierTicks) {
+        resetGame(game, KNOWN_SEED + 1);
+        Controller controller = findController("greedy");
+        for (int i = 0; i < ticks && game.result == RUNNING; ++i) {
+            step(game, controller(game, botRng));
+        }
+        resetGame(game, KNOWN_SEED);
+        botRng = Rng();
+        playGame(game, controller, botRng, static_cast<long long>(config.cols) * config.rows);
+        check(game.score == KNOWN_SCORE && game.ticks == KNOWN_TICKS, "a known seed plays out the same after a reset");
     }
 }
 
-void displayGameOver() {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string gameOverText = "Game Over\n\nYour score: " + std::to_string(score);
-
-    // Render "Game Over" message with score
-    SDL_Surface* gameOverSurface = TTF_RenderText_Solid(font, gameOverText.c_str(), textColor);
-    SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-
-    SDL_Rect gameOverRect = {(SCREEN_WIDTH - gameOverSurface->w) / 2, (SCREEN_HEIGHT - gameOverSurface->h) / 2,
-                             gameOverSurface->w, gameOverSurface->h};
-    SDL_RenderCopy(renderer, gameOverTexture, nullptr, &gameOverRect);
-
-    SDL_FreeSurface(gameOverSurface);
-    SDL_DestroyTexture(gameOverTexture);
-
-    SDL_RenderPresent(renderer);
+int main(int argc, char* args[]) {
+    int games = argc > 1 ? std::atoi(args[1]) : 1000;
+    uint64_t seed = argc > 2 ? std::strtoull(args[2], nullptr, 10) : static_cast<uint64_t>(std::time(0));
+
+    GameConfig config = alternateLayout();
+
+    checkBodies();
+    checkWallHit();
+    checkSelfCollision();
+    checkWrapAround();
+    checkBonusTimer();
+    checkEndlessCoil();
+    checkEndlessChunks();
+    checkFoodPlacement(config);
+    checkKnownSeed(config);
+    std::cout << "checks:       " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+
+    GameState game;
+    initGame(game, config, seed);
+
+    long long totalTicks = 0;
+    long long totalScore = 0;
+    long long totalLength = 0;
+    int endings[BOARD_FULL + 1] = {};
+    int stalled = 0;
+
+    // Give up on a game once the bot has gone a whole board's worth of steps without eating
+    const long long stallTicks = static_cast<long long>(config.cols) * config.rows;
+    Controller controller = findController("greedy");
+    Rng botRng;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < games; ++i) {
+        resetGame(game, seed + i);
+        playGame(game, controller, botRng, stallTicks);
+
+        totalTicks += game.ticks;
+        totalScore += game.score;
+        totalLength += game.snake.size();
+        if (game.result == RUNNING) {
+            ++stalled;
+        } else {
+            ++endings[game.result];
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
 
-    // Wait for a few seconds before exiting
-    SDL_Delay(3000);
+    if (games <= 0) {
+        return failures == 0 ? 0 : 1;
+    }
 
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    TTF_CloseFont(font);
-    TTF_Quit();
-    SDL_Quit();
-    exit(0);
-}
\ No newline at end of file
+    std::cout << "games:        " << games << " (seed " << seed << ")" << std::endl;
+    std::cout << "mean score:   " << static_cast<double>(totalScore) / games << std::endl;
+    std::cout << "mean length:  " << static_cast<double>(totalLength) / games << std::endl;
+    std::cout << "mean ticks:   " << static_cast<double>(totalTicks) / games << std::endl;
+    std::cout << "hit wall:     " << endings[HIT_WALL] << std::endl;
+    std::cout << "hit self:     " << endings[HIT_SELF] << std::endl;
+    std::cout << "board full:   " << endings[BOARD_FULL] << std::endl;
+    std::cout << "stalled:      " << stalled << std::endl;
+    std::cout << "ticks/sec:    " << totalTicks / seconds << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include "text_cache.h"
+#include "profiler.h"
+
+#include <iostream>
+
+void initTextCache(TextCache& cache, TTF_Font* font, size_t capacity) {
+    clearTextCache(cache);
+    cache.font = font;
+    cache.capacity = capacity;
+}
+
+void clearTextCache(TextCache& cache) {
+    for (TextCacheEntry& entry : cache.entries) {
+        SDL_DestroyTexture(entry.texture);
+    }
+    cache.entries.clear();
+    cache.index.clear();
+}
+
+// The color is part of the key, so the same text in two colors is two entries
+static std::string cacheKey(const std::string& text, SDL_Color color) {
+    std::string key = text;
+    key.push_back('\0');
+    key.push_back(static_cast<char>(color.r));
+    key.push_back(static_cast<char>(color.g));
+    key.push_back(static_cast<char>(color.b));
+    key.push_back(static_cast<char>(color.a));
+    return key;
+}
+
+const TextCacheEntry* lookupText(SDL_Renderer* renderer, TextCache& cache, const std::string& text, SDL_Color color) {
+    if (text.empty()) {
+        return nullptr;
+    }
+
+    std::string key = cacheKey(text, color);
+    auto found = cache.index.find(key);
+    if (found != cache.index.end()) {
+        ++cache.hits;
+        cache.entries.splice(cache.entries.begin(), cache.entries, found->second);
+        return &cache.entries.front();
+    }
+
+    ++cache.misses;
+    PROFILE_ZONE("rasterize text");
+    SDL_Surface* surface = TTF_RenderUTF8_Blended(cache.font, text.c_str(), color);
+    if (!surface) {
+        std::cerr << "Failed to render text: " << TTF_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    int w = surface->w;
+    int h = surface->h;
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        std::cerr << "Failed to create text texture: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    cache.entries.push_front({key, texture, w, h});
+    cache.index[key] = cache.entries.begin();
+
+    while (cache.entries.size() > cache.capacity && cache.entries.size() > 1) {
+        TextCacheEntry& oldest = cache.entries.back();
+        SDL_DestroyTexture(oldest.texture);
+        cache.index.erase(oldest.key);
+        cache.entries.pop_back();
+    }
+    return &cache.entries.front();
+}
+
+int measureCachedText(SDL_Renderer* renderer, TextCache& cache, const std::string& text, SDL_Color color) {
+    const TextCacheEntry* entry = lookupText(renderer, cache, text, color);
+    return entry ? entry->w : 0;
+}
+
+void drawCachedText(SDL_Renderer* renderer, TextCache& cache, const std::string& text, int x, int y, SDL_Color color) {
+    const TextCacheEntry* entry = lookupText(renderer, cache, text, color);
+    if (entry) {
+        SDL_Rect dst = {x, y, entry->w, entry->h};
+        SDL_RenderCopy(renderer, entry->texture, nullptr, &dst);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Whole strings rasterized once into their own texture and reused while
+// they stay in the cache. Entries are keyed by text and color and kept in
+// least recently used order; once the cache is over capacity the oldest
+// entry's texture is destroyed. Unlike the glyph atlas this keeps the
+// font's kerning, at the cost of one texture per distinct string.
+struct TextCacheEntry {
+    std::string key;
+    SDL_Texture* texture;
+    int w, h;
+};
+
+struct TextCache {
+    TTF_Font* font = nullptr;
+    size_t capacity = 0;
+
+    std::list<TextCacheEntry> entries;  // Most recently used first
+    std::unordered_map<std::string, std::list<TextCacheEntry>::iterator> index;
+
+    long long hits = 0;
+    long long misses = 0;
+};
+
+void initTextCache(TextCache& cache, TTF_Font* font, size_t capacity);
+
+// Destroys every cached texture; call before the renderer goes away or
+// after it lost its textures
+void clearTextCache(TextCache& cache);
+
+// The texture for text in color, rasterizing it on a miss. nullptr if
+// the text is empty or could not be rendered.
+const TextCacheEntry* lookupText(SDL_Renderer* renderer, TextCache& cache, const std::string& text, SDL_Color color);
+
+int measureCachedText(SDL_Renderer* renderer, TextCache& cache, const std::string& text, SDL_Color color);
+void drawCachedText(SDL_Renderer* renderer, TextCache& cache, const std::string& text, int x, int y, SDL_Color color);
+
+#endif
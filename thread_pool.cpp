@@ -0,0 +1,103 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        queues.emplace_back(new Worker);
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    pending.fetch_add(1);
+    Worker& worker = *queues[nextQueue.fetch_add(1) % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    // Taking sleepMutex orders this notify after a worker's last empty check
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_all();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this] { return pending.load() == 0; });
+}
+
+bool ThreadPool::popLocal(int self, std::function<void()>& task) {
+    Worker& worker = *queues[self];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(int self, std::function<void()>& task) {
+    int count = static_cast<int>(queues.size());
+    for (int offset = 1; offset < count; ++offset) {
+        Worker& victim = *queues[(self + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(int self) {
+    std::function<void()> task;
+    while (true) {
+        if (popLocal(self, task) || steal(self, task)) {
+            task();
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping) {
+            return;
+        }
+        // Nothing to run or steal: sleep until submit() or shutdown. The
+        // predicate re-checks under sleepMutex so a wakeup cannot be missed.
+        wake.wait(lock, [this] {
+            if (stopping) {
+                return true;
+            }
+            for (const auto& queue : queues) {
+                std::lock_guard<std::mutex> queueLock(queue->mutex);
+                if (!queue->tasks.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+}
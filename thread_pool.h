@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker
+// takes its newest task first and, when its deque runs dry, steals the
+// oldest task from another worker, so uneven tasks (games that last much
+// longer than others) still keep every core busy.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task on the next worker in round-robin order
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(int self);
+    bool popLocal(int self, std::function<void()>& task);
+    bool steal(int self, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;     // Signalled when tasks arrive or on shutdown
+    std::condition_variable idle;     // Signalled when pending drops to zero
+    std::atomic<int> pending{0};      // Submitted but not yet finished
+    std::atomic<unsigned> nextQueue{0};
+    bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef TIMER_QUEUE_H
+#define TIMER_QUEUE_H
+
+#include <utility>
+#include <vector>
+
+// Timed events keyed by the simulation tick they fire on, in a binary
+// min-heap. schedule, cancel and popping the next due event are all
+// O(log n), so many live timers cost no more per tick than one.
+//
+// Events due on the same tick fire in the order they were scheduled, so a
+// seeded game always handles them the same way. A timer is identified by
+// the handle schedule() returns; slots keeps each live timer's place in
+// heap (like FreeCellSet's position map) so cancel can find it. The heap
+// entries carry their own sort key so sifting stays within one array.
+class TimerQueue {
+public:
+    struct Timer {
+        long long tick;
+        int event;          // What to do, chosen by the owner
+        int target;         // Which entity it applies to, if the owner needs one
+    };
+
+    void clear() {
+        heap.clear();
+        slots.clear();
+        freeSlots.clear();
+        nextSequence = 0;
+    }
+
+    // Returns a handle for cancel(). Handles are reused once their timer
+    // fires or is cancelled, so owners must forget them at that point.
+    int schedule(long long tick, int event, int target = 0) {
+        int handle;
+        if (freeSlots.empty()) {
+            handle = static_cast<int>(slots.size());
+            slots.push_back({});
+        } else {
+            handle = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        slots[handle] = {event, target, static_cast<int>(heap.size())};
+        heap.push_back({tick, nextSequence++, handle});
+        siftUp(static_cast<int>(heap.size()) - 1);
+        return handle;
+    }
+
+    // Does nothing for a handle that is not live
+    void cancel(int handle) {
+        if (!isPending(handle)) {
+            return;
+        }
+        removeAt(slots[handle].heapIndex);
+    }
+
+    bool isPending(int handle) const {
+        return handle >= 0 && handle < static_cast<int>(slots.size()) && slots[handle].heapIndex >= 0;
+    }
+
+    // Takes the earliest timer due at or before tick, if there is one
+    bool popDue(long long tick, Timer& fired) {
+        if (heap.empty() || heap[0].tick > tick) {
+            return false;
+        }
+        const Slot& slot = slots[heap[0].handle];
+        fired = {heap[0].tick, slot.event, slot.target};
+        removeAt(0);
+        return true;
+    }
+
+    int size() const { return static_cast<int>(heap.size()); }
+    bool empty() const { return heap.empty(); }
+
+private:
+    struct Entry {
+        long long tick;
+        unsigned long long sequence;
+        int handle;
+    };
+
+    struct Slot {
+        int event;
+        int target;
+        int heapIndex;          // -1 once fired or cancelled
+    };
+
+    bool earlier(int a, int b) const {
+        const Entry& x = heap[a];
+        const Entry& y = heap[b];
+        return x.tick < y.tick || (x.tick == y.tick && x.sequence < y.sequence);
+    }
+
+    void swapEntries(int a, int b) {
+        std::swap(heap[a], heap[b]);
+        slots[heap[a].handle].heapIndex = a;
+        slots[heap[b].handle].heapIndex = b;
+    }
+
+    void siftUp(int i) {
+        while (i > 0 && earlier(i, (i - 1) / 2)) {
+            swapEntries(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void siftDown(int i) {
+        int count = static_cast<int>(heap.size());
+        while (true) {
+            int smallest = i;
+            int left = 2 * i + 1;
+            int right = left + 1;
+            if (left < count && earlier(left, smallest)) {
+                smallest = left;
+            }
+            if (right < count && earlier(right, smallest)) {
+                smallest = right;
+            }
+            if (smallest == i) {
+                return;
+            }
+            swapEntries(i, smallest);
+            i = smallest;
+        }
+    }
+
+    // Moves the last entry into the hole, then restores the heap in whichever direction it needs
+    void removeAt(int i) {
+        int handle = heap[i].handle;
+        int last = static_cast<int>(heap.size()) - 1;
+        if (i != last) {
+            swapEntries(i, last);
+        }
+        heap.pop_back();
+        slots[handle].heapIndex = -1;
+        freeSlots.push_back(handle);
+
+        if (i < last) {
+            siftDown(i);
+            siftUp(i);
+        }
+    }
+
+    std::vector<Entry> heap;        // Min-heap on (tick, sequence)
+    std::vector<Slot> slots;        // Indexed by handle
+    std::vector<int> freeSlots;
+    unsigned long long nextSequence = 0;
+};
+
+#endif
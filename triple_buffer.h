@@ -0,0 +1,52 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Hands the newest value from one writer thread to one reader thread
+// without locks or waiting. There are three slots: the writer fills the
+// back one, the reader looks at the front one, and the third sits in the
+// middle holding the latest published value. publish() swaps back and
+// middle, refresh() swaps middle and front, each with a single atomic
+// exchange, so neither side ever sees a slot the other is using.
+//
+// The reader always gets the newest complete value; values published
+// faster than it refreshes are simply skipped. A slot is reused rather
+// than reallocated, so T's buffers keep their capacity across swaps.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side: fill back(), then publish() it
+    T& back() { return slots[backIndex]; }
+
+    void publish() {
+        int previous = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel);
+        backIndex = previous & INDEX;
+    }
+
+    // Reader side: returns true if front() changed. front() is a default
+    // T until the first refresh() after the first publish().
+    bool refresh() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        int previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;     // Set in middle when it holds a value the reader has not taken
+
+    T slots[3];
+
+    // Each side's index on its own cache line, away from the shared one
+    alignas(64) int backIndex = 0;
+    alignas(64) std::atomic<int> middle{1};
+    alignas(64) int frontIndex = 2;
+};
+
+#endif